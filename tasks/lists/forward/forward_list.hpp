@@ -1,120 +1,294 @@
 #pragma once
 
 #include <cstdlib>
+#include <cstddef>
 #include <iterator>
 #include <functional>
+#include <memory>
+#include <stdexcept>
 #include <utility>
 
 #include <fmt/core.h>
 
-
-template <typename T>
+// Singly linked list. Nodes come from Allocator rebound to the node type, so
+// any std::allocator-compatible allocator (an arena, a node pool) can supply them.
+template <typename T, typename Allocator = std::allocator<T>>
 class ForwardList{
 private:
-  class Node{
-    friend class ForwardListIterator;
-    friend class ForwardList;
-    /*???*/
+  // The list itself holds one BaseNode before the first node, so inserting
+  // at the front is the same as inserting after any other node
+  struct BaseNode {
+    BaseNode* next;
+  };
 
-    private:
-      /*???*/
+  struct Node : BaseNode {
+    template <typename... Args>
+    explicit Node(Args&&... args) : BaseNode{nullptr}, value(std::forward<Args>(args)...) {
+    }
 
+    T value;
   };
+
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
 public:
   class ForwardListIterator{
     public:
-    /*???*/
+      using value_type = T;
+      using reference_type = value_type&;
+      using pointer_type = value_type*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::forward_iterator_tag;
+      // Names std::iterator_traits looks for
+      using reference = reference_type;
+      using pointer = pointer_type;
+
+      ForwardListIterator() = default;
+
+      inline bool operator==(const ForwardListIterator& other) const {
+          return current == other.current;
+      };
+
+      inline bool operator!=(const ForwardListIterator& other) const {
+          return current != other.current;
+      };
+
+      inline reference_type operator*() const {
+          return static_cast<Node*>(current)->value;
+      };
+
+      ForwardListIterator& operator++() {
+          current = current->next;
+          return *this;
+      };
+
+      ForwardListIterator operator++(int) {
+          ForwardListIterator old = *this;
+          current = current->next;
+          return old;
+      };
+
+      inline pointer_type operator->() const {
+          return &static_cast<Node*>(current)->value;
+      };
 
   private:
-      ForwardListIterator(const Node*) {
-          // Not implemented
+      friend class ForwardList;
+
+      explicit ForwardListIterator(const BaseNode* node) : current(const_cast<BaseNode*>(node)) {
       }
+
   private:
-      Node* current;
+      BaseNode* current = nullptr;
   };
 
 public:
-  ForwardList() {
-    // Not implemented
+  ForwardList() : ForwardList(Allocator()) {
+  }
+
+  explicit ForwardList(const Allocator& alloc) : before_head_{nullptr}, size_(0), alloc_(alloc) {
+  }
+
+  explicit ForwardList(size_t sz, const Allocator& alloc = Allocator()) : ForwardList(alloc) {
+    for (size_t i = 0; i < sz; ++i) {
+      CreateAfter(&before_head_);
+    }
   }
 
-  explicit ForwardList(size_t /*sz*/) {
-    // Not implemented
+  ForwardList(const std::initializer_list<T>& values, const Allocator& alloc = Allocator())
+      : ForwardList(alloc) {
+    AppendRange(values.begin(), values.end());
   }
 
-  ForwardList(const std::initializer_list<T>& /*values*/) {
-    // Not implemented
+  ForwardList(const ForwardList& other)
+      : ForwardList(other, NodeTraits::select_on_container_copy_construction(other.alloc_)) {
   }
 
-  ForwardList(const ForwardList& /*other*/) {
-    // Not implemented
+  ForwardList(const ForwardList& other, const Allocator& alloc) : ForwardList(alloc) {
+    AppendRange(other.Begin(), other.End());
   }
 
-  ForwardList& operator=(const ForwardList& /*other*/) {
-    std::abort(); // Not implemented
+  ForwardList& operator=(const ForwardList& other) {
+    if (this != &other) {
+      Clear();
+      if constexpr (NodeTraits::propagate_on_container_copy_assignment::value) {
+        alloc_ = other.alloc_;
+      }
+      AppendRange(other.Begin(), other.End());
+    }
+    return *this;
+  }
+
+  ForwardList(ForwardList&& other) noexcept
+      : before_head_{std::exchange(other.before_head_.next, nullptr)},
+        size_(std::exchange(other.size_, 0)),
+        alloc_(std::move(other.alloc_)) {
+  }
+
+  ForwardList& operator=(ForwardList&& other) noexcept(
+      NodeTraits::propagate_on_container_move_assignment::value || NodeTraits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    if constexpr (NodeTraits::propagate_on_container_move_assignment::value) {
+      alloc_ = std::move(other.alloc_);
+    } else if (!(alloc_ == other.alloc_)) {
+      // Our allocator cannot free the other nodes: move the elements instead
+      BaseNode* last = &before_head_;
+      for (auto it = other.Begin(); it != other.End(); ++it) {
+        last = CreateAfter(last, std::move(*it));
+      }
+      other.Clear();
+      return *this;
+    }
+    before_head_.next = std::exchange(other.before_head_.next, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
   }
 
   ForwardListIterator Begin() const noexcept {
-    std::abort(); // Not implemented
+    return ForwardListIterator(before_head_.next);
   }
 
   ForwardListIterator End() const noexcept {
-    std::abort(); // Not implemented
+    return ForwardListIterator(nullptr);
   }
 
   inline T& Front() const {
-    std::abort(); // Not implemented
+    return static_cast<Node*>(before_head_.next)->value;
   }
 
   inline bool IsEmpty() const noexcept {
-    std::abort(); // Not implemented
+    return size_ == 0;
   }
 
   inline size_t Size() const noexcept {
-    std::abort(); // Not implemented
+    return size_;
+  }
+
+  Allocator GetAllocator() const {
+    return Allocator(alloc_);
+  }
+
+  void Swap(ForwardList& other) {
+    if constexpr (NodeTraits::propagate_on_container_swap::value) {
+      std::swap(alloc_, other.alloc_);
+    }
+    std::swap(before_head_.next, other.before_head_.next);
+    std::swap(size_, other.size_);
   }
 
-  void Swap(ForwardList& /*a*/) {
-    // Not implemented
+  // Erases the element following pos, which must exist
+  void EraseAfter(ForwardListIterator pos) {
+    BaseNode* prev = pos.current;
+    BaseNode* node = prev->next;
+    prev->next = node->next;
+    DestroyNode(static_cast<Node*>(node));
+    --size_;
   }
 
-  void EraseAfter(ForwardListIterator /*pos*/) {
-    // Not implemented
+  void InsertAfter(ForwardListIterator pos, const T& value) {
+    CreateAfter(pos.current, value);
   }
 
-  void InsertAfter(ForwardListIterator /*pos*/, const T& /*value*/) {
-    // Not implemented
+  void InsertAfter(ForwardListIterator pos, T&& value) {
+    CreateAfter(pos.current, std::move(value));
   }
 
-  ForwardListIterator Find(const T& /*value*/) const {
-    std::abort(); // Not implemented
+  // Constructs the element from args inside the new node, right after pos
+  template <typename... Args>
+  ForwardListIterator EmplaceAfter(ForwardListIterator pos, Args&&... args) {
+    return ForwardListIterator(CreateAfter(pos.current, std::forward<Args>(args)...));
+  }
+
+  ForwardListIterator Find(const T& value) const {
+    for (auto it = Begin(); it != End(); ++it) {
+      if (*it == value) {
+        return it;
+      }
+    }
+    return End();
   }
 
   void Clear() noexcept {
-    // Not implemented
+    BaseNode* node = before_head_.next;
+    while (node != nullptr) {
+      BaseNode* next = node->next;
+      DestroyNode(static_cast<Node*>(node));
+      node = next;
+    }
+    before_head_.next = nullptr;
+    size_ = 0;
+  }
+
+  void PushFront(const T& value) {
+    CreateAfter(&before_head_, value);
+  }
+
+  void PushFront(T&& value) {
+    CreateAfter(&before_head_, std::move(value));
   }
 
-  void PushFront(const T& /*value*/) {
-    // Not implemented
+  template <typename... Args>
+  T& EmplaceFront(Args&&... args) {
+    return CreateAfter(&before_head_, std::forward<Args>(args)...)->value;
   }
 
   void PopFront() {
-    // Not implemented
+    if (IsEmpty()) {
+      throw std::runtime_error("PopFront from an empty list");
+    }
+    EraseAfter(ForwardListIterator(&before_head_));
   }
 
   ~ForwardList() {
-    // Not implemented
+    Clear();
+  }
+
+private:
+  // Constructs a node from args and links it right after pos
+  template <typename... Args>
+  Node* CreateAfter(BaseNode* pos, Args&&... args) {
+    Node* node = NodeTraits::allocate(alloc_, 1);
+    try {
+      NodeTraits::construct(alloc_, node, std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(alloc_, node, 1);
+      throw;
+    }
+    node->next = pos->next;
+    pos->next = node;
+    ++size_;
+    return node;
+  }
+
+  void DestroyNode(Node* node) noexcept {
+    NodeTraits::destroy(alloc_, node);
+    NodeTraits::deallocate(alloc_, node, 1);
+  }
+
+  // Appends copies of [first, last) at the end; only called on an empty list
+  template <typename It>
+  void AppendRange(It first, It last) {
+    BaseNode* tail = &before_head_;
+    for (; first != last; ++first) {
+      tail = CreateAfter(tail, *first);
+    }
   }
 
 private:
-  /*???*/
+  BaseNode before_head_;
+  size_t size_;
+  [[no_unique_address]] NodeAllocator alloc_;
 };
 
 
 namespace std {
   // Global swap overloading
-  template <typename T>
-  void swap(ForwardList<T>& a, ForwardList<T>& b) {
+  template <typename T, typename Allocator>
+  void swap(ForwardList<T, Allocator>& a, ForwardList<T, Allocator>& b) {
     a.Swap(b);
   }
 }
@@ -158,9 +158,42 @@ void BM_StdListFind(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// How a std::string the caller has just built reaches the node
+enum class Pass {
+  Copy,
+  Move,
+  Emplace,
+};
+
+// Longer than the small string buffer, so every copy allocates
+const std::string payload(64, 'x');
+
+template <Pass P>
+void BM_CustomListStringPushFront(benchmark::State& state) {
+  ForwardList<std::string> list;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      if constexpr (P == Pass::Copy) {
+        std::string value(payload);
+        list.PushFront(value);
+      } else if constexpr (P == Pass::Move) {
+        std::string value(payload);
+        list.PushFront(std::move(value));
+      } else {
+        list.EmplaceFront(payload);
+      }
+    }
+    list.Clear();
+  }
+  state.counters["time/op"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * state.range(0)), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
 
 BENCHMARK(BM_CustomListPushFront)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListPushFront)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomListStringPushFront, Pass::Copy)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_CustomListStringPushFront, Pass::Move)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_CustomListStringPushFront, Pass::Emplace)->Range(1<<10, 1<<16);
 BENCHMARK(BM_CustomListMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
@@ -1,4 +1,6 @@
 #include <forward_list>
+#include <memory>
+#include <string>
 #include <thread>
 #include <future>
 
@@ -10,13 +12,13 @@
 class ListTest: public testing::Test {
   protected:
     void SetUp() override {
-      list.PushFront(1);
-      list.PushFront(2);
-      list.PushFront(3);
-      list.PushFront(4);
-      list.PushFront(5);
-      list.PushFront(6);
       list.PushFront(7);
+      list.PushFront(6);
+      list.PushFront(5);
+      list.PushFront(4);
+      list.PushFront(3);
+      list.PushFront(2);
+      list.PushFront(1);
       assert(list.Size() == sz);
     }
   ForwardList<int> list;
@@ -77,8 +79,8 @@ TEST(EmptyListTest, Swap) {
   list.PushFront(5);
 
   ForwardList<int> lst;
-  lst.PushFront(15);
   lst.PushFront(14);
+  lst.PushFront(15);
 
   size_t old_mp_size = list.Size();
   size_t old_dict_size = lst.Size();
@@ -101,7 +103,9 @@ TEST_F(ListTest, CopyConstructor) {
   while (!lst.IsEmpty()) {
     ASSERT_EQ(list.Front(), lst.Front());
     list.PopFront();
-    ASSERT_NE(list.Front(), lst.Front());
+    if (!list.IsEmpty()) {
+      ASSERT_NE(list.Front(), lst.Front());
+    }
     lst.PopFront();
   }
 }
@@ -126,7 +130,7 @@ TEST_F(ListTest, SelfAssignment) {
   auto future = std::async(std::launch::async, &std::thread::join, &thread);
   ASSERT_EQ(
     future.wait_for(std::chrono::seconds(1)),
-    std::future_status::timeout
+    std::future_status::ready
   ) << "There is infinity loop!\n";
 }
 
@@ -149,15 +153,15 @@ TEST_F(ListTest, RangeWithIteratorPostFix) {
 }
 
 TEST_F(ListTest, EraseBegin) {
-  int second_value = *(list.Begin()++);
+  int second_value = *(++list.Begin());
   list.EraseAfter(list.Begin());
   ASSERT_EQ(list.Size(), sz - 1);
-  ASSERT_NE(*(list.Begin()++), second_value);
+  ASSERT_NE(*(++list.Begin()), second_value);
 }
 
 TEST_F(ListTest, EraseMedium) {
   auto it = list.Begin();
-  std::advance(it, list.Size() / 2);
+  std::advance(it, list.Size() / 2 - 1);
   list.EraseAfter(it);
   ASSERT_EQ(list.Size(), sz - 1);
   for (auto it = list.Begin(); it != list.End(); ++it) {
@@ -182,6 +186,33 @@ TEST_F(ListTest, Clear) {
 }
 
 
+TEST(ForwardListEmplaceTest, MoveOnlyValues) {
+  ForwardList<std::unique_ptr<int>> list;
+  list.PushFront(std::make_unique<int>(3));
+  list.PushFront(std::make_unique<int>(1));
+  list.InsertAfter(list.Begin(), std::make_unique<int>(2));
+  auto it = list.Begin();
+  std::advance(it, 2);
+  auto last = list.EmplaceAfter(it, new int(4));
+  ASSERT_EQ(**last, 4);
+  int expected = 1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(**it, expected++);
+  }
+  ASSERT_EQ(list.Size(), 4);
+}
+
+TEST(ForwardListEmplaceTest, ConstructsInPlace) {
+  ForwardList<std::string> list;
+  std::string& front = list.EmplaceFront(3, 'a');
+  ASSERT_EQ(front, "aaa");
+  ASSERT_EQ(&front, &list.Front());
+  std::string moved = "moved into the node, long enough to live on the heap";
+  const char* buffer = moved.data();
+  list.PushFront(std::move(moved));
+  ASSERT_EQ(list.Front().data(), buffer);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+enum class HookMode {
+  // The hook is two pointers and nothing is checked
+  Normal,
+  // Unlinked hooks are null, so inserting an object that is already in a list throws
+  Safe,
+};
+
+// Links of an object in an IntrusiveList. The object inherits the hook, one
+// per list it may be in at the same time, told apart by Tag:
+//
+//     struct Task : IntrusiveListHook<>, IntrusiveListHook<struct ByDeadline> { ... };
+//     IntrusiveList<Task> queue;
+//     IntrusiveList<Task, IntrusiveListHook<ByDeadline>> deadlines;
+//
+// Copying an object does not copy its membership: the copy starts unlinked.
+template <typename Tag = void, HookMode Mode = HookMode::Normal>
+class IntrusiveListHook {
+public:
+  static constexpr bool IsSafe = Mode == HookMode::Safe;
+
+  IntrusiveListHook() = default;
+
+  IntrusiveListHook(const IntrusiveListHook&) noexcept {
+  }
+
+  IntrusiveListHook& operator=(const IntrusiveListHook&) noexcept {
+    return *this;
+  }
+
+  bool IsLinked() const noexcept requires IsSafe {
+    return next_ != nullptr;
+  }
+
+private:
+  template <typename T, typename Hook>
+  friend class IntrusiveList;
+
+  IntrusiveListHook* prev_ = nullptr;
+  IntrusiveListHook* next_ = nullptr;
+};
+
+// Doubly linked list of objects that carry their own links, so inserting
+// allocates nothing and an object is unlinked in O(1) knowing only its
+// address. The list does not own the objects: they must outlive their
+// membership, and Clear() or the destructor only unlinks them.
+template <typename T, typename Hook = IntrusiveListHook<>>
+class IntrusiveList {
+  static_assert(std::is_base_of_v<Hook, T>, "T must inherit the hook of the list");
+
+public:
+  class ListIterator{
+    public:
+      using value_type = T;
+      using reference_type = value_type&;
+      using pointer_type = value_type*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::bidirectional_iterator_tag;
+      // Names std::iterator_traits looks for
+      using reference = reference_type;
+      using pointer = pointer_type;
+
+      ListIterator() = default;
+
+      inline bool operator==(const ListIterator& other) const {
+          return current == other.current;
+      };
+
+      inline bool operator!=(const ListIterator& other) const {
+          return current != other.current;
+      };
+
+      inline reference_type operator*() const {
+          return static_cast<T&>(*current);
+      };
+
+      ListIterator& operator++() {
+          current = current->next_;
+          return *this;
+      };
+
+      ListIterator operator++(int) {
+          ListIterator old = *this;
+          current = current->next_;
+          return old;
+      };
+
+      ListIterator& operator--() {
+          current = current->prev_;
+          return *this;
+      };
+
+      ListIterator operator--(int) {
+          ListIterator old = *this;
+          current = current->prev_;
+          return old;
+      };
+
+      inline pointer_type operator->() const {
+          return static_cast<T*>(current);
+      };
+
+  private:
+      friend class IntrusiveList;
+
+      explicit ListIterator(const Hook* hook) : current(const_cast<Hook*>(hook)) {
+      }
+
+  private:
+      Hook* current = nullptr;
+  };
+
+public:
+  IntrusiveList() noexcept {
+    Reset();
+  }
+
+  IntrusiveList(const IntrusiveList&) = delete;
+  IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+  IntrusiveList(IntrusiveList&& other) noexcept {
+    Reset();
+    Swap(other);
+  }
+
+  IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+    if (this != &other) {
+      Clear();
+      Swap(other);
+    }
+    return *this;
+  }
+
+  ListIterator Begin() const noexcept {
+    return ListIterator(head_.next_);
+  }
+
+  ListIterator End() const noexcept {
+    return ListIterator(&head_);
+  }
+
+  // Iterator to an object of this list, found from the object itself in O(1)
+  ListIterator IteratorTo(T& object) const noexcept {
+    return ListIterator(&static_cast<Hook&>(object));
+  }
+
+  inline T& Front() const {
+    return *Begin();
+  }
+
+  inline T& Back() const {
+    return static_cast<T&>(*head_.prev_);
+  }
+
+  inline bool IsEmpty() const noexcept {
+    return size_ == 0;
+  }
+
+  inline size_t Size() const noexcept {
+    return size_;
+  }
+
+  void Swap(IntrusiveList& other) noexcept {
+    std::swap(head_.prev_, other.head_.prev_);
+    std::swap(head_.next_, other.head_.next_);
+    std::swap(size_, other.size_);
+    RelinkSentinel();
+    other.RelinkSentinel();
+  }
+
+  ListIterator Find(const T& value) const {
+    for (auto it = Begin(); it != End(); ++it) {
+      if (*it == value) {
+        return it;
+      }
+    }
+    return End();
+  }
+
+  // Links object right before pos and returns an iterator to it
+  ListIterator Insert(ListIterator pos, T& object) {
+    Hook* hook = &static_cast<Hook&>(object);
+    if constexpr (Hook::IsSafe) {
+      if (hook->IsLinked()) {
+        throw std::logic_error("Object is already linked into a list");
+      }
+    }
+    Hook* next = pos.current;
+    hook->prev_ = next->prev_;
+    hook->next_ = next;
+    next->prev_->next_ = hook;
+    next->prev_ = hook;
+    ++size_;
+    return ListIterator(hook);
+  }
+
+  void Erase(ListIterator pos) noexcept {
+    Unlink(pos.current);
+    --size_;
+  }
+
+  // Unlinks object, which must be in this list, without searching for it
+  void Erase(T& object) noexcept {
+    Erase(IteratorTo(object));
+  }
+
+  void Clear() noexcept {
+    if constexpr (Hook::IsSafe) {
+      Hook* hook = head_.next_;
+      while (hook != &head_) {
+        Hook* next = hook->next_;
+        hook->prev_ = nullptr;
+        hook->next_ = nullptr;
+        hook = next;
+      }
+    }
+    Reset();
+  }
+
+  void PushBack(T& object) {
+    Insert(End(), object);
+  }
+
+  void PushFront(T& object) {
+    Insert(Begin(), object);
+  }
+
+  void PopBack() {
+    if (IsEmpty()) {
+      throw std::runtime_error("PopBack from an empty list");
+    }
+    Erase(ListIterator(head_.prev_));
+  }
+
+  void PopFront() {
+    if (IsEmpty()) {
+      throw std::runtime_error("PopFront from an empty list");
+    }
+    Erase(Begin());
+  }
+
+  ~IntrusiveList() {
+    Clear();
+  }
+
+private:
+  // Empty state: the sentinel points to itself
+  void Reset() noexcept {
+    head_.prev_ = &head_;
+    head_.next_ = &head_;
+    size_ = 0;
+  }
+
+  static void Unlink(Hook* hook) noexcept {
+    hook->prev_->next_ = hook->next_;
+    hook->next_->prev_ = hook->prev_;
+    if constexpr (Hook::IsSafe) {
+      hook->prev_ = nullptr;
+      hook->next_ = nullptr;
+    }
+  }
+
+  // Points the first and the last object back to our sentinel after swapping the links of head_
+  void RelinkSentinel() noexcept {
+    if (size_ == 0) {
+      Reset();
+      return;
+    }
+    head_.next_->prev_ = &head_;
+    head_.prev_->next_ = &head_;
+  }
+
+private:
+  Hook head_;
+  size_t size_;
+};
+
+
+namespace std {
+  // Global swap overloading
+  template <typename T, typename Hook>
+  void swap(IntrusiveList<T, Hook>& a, IntrusiveList<T, Hook>& b) {
+    a.Swap(b);
+  }
+}
@@ -1,26 +1,40 @@
 #pragma once
 
 #include <cstdlib>
+#include <algorithm>
 #include <cstddef>
 #include <iterator>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <utility>
 
 #include <fmt/core.h>
 
-template <typename T>
+// Doubly linked list. Nodes come from Allocator rebound to the node type, so
+// any std::allocator-compatible allocator (an arena, a node pool) can supply them.
+template <typename T, typename Allocator = std::allocator<T>>
 class List{
 private:
-  class Node{
-    friend class ListIterator;
-    friend class List;
-    /*???*/
+  // The list itself holds one BaseNode: a sentinel that is both before the
+  // first node and after the last one, so End() can be decremented
+  struct BaseNode {
+    BaseNode* prev;
+    BaseNode* next;
+  };
 
-    private:
-      /*???*/
+  struct Node : BaseNode {
+    template <typename... Args>
+    explicit Node(Args&&... args) : BaseNode{nullptr, nullptr}, value(std::forward<Args>(args)...) {
+    }
 
+    T value;
   };
 
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
 public:
   class ListIterator{
     public:
@@ -29,144 +43,528 @@ public:
       using pointer_type = value_type*;
       using difference_type = std::ptrdiff_t;
       using iterator_category = std::bidirectional_iterator_tag;
+      // Names std::iterator_traits looks for
+      using reference = reference_type;
+      using pointer = pointer_type;
+
+      ListIterator() = default;
 
-      inline bool operator==(const ListIterator&) const {
-          std::abort(); // Not implemented
+      inline bool operator==(const ListIterator& other) const {
+          return current == other.current;
       };
 
-      inline bool operator!=(const ListIterator&) const {
-          std::abort(); // Not implemented
+      inline bool operator!=(const ListIterator& other) const {
+          return current != other.current;
       };
 
       inline reference_type operator*() const {
-          std::abort(); // Not implemented
+          return static_cast<Node*>(current)->value;
       };
 
       ListIterator& operator++() {
-          std::abort(); // Not implemented
+          current = current->next;
+          return *this;
       };
 
       ListIterator operator++(int) {
-          std::abort(); // Not implemented
+          ListIterator old = *this;
+          current = current->next;
+          return old;
       };
 
       ListIterator& operator--() {
-          std::abort(); // Not implemented
+          current = current->prev;
+          return *this;
       };
 
       ListIterator operator--(int) {
-          std::abort(); // Not implemented
+          ListIterator old = *this;
+          current = current->prev;
+          return old;
       };
 
-      /*The overload of operator -> must either return a raw pointer, 
-      or return an object (by reference or by value) for which 
+      /*The overload of operator -> must either return a raw pointer,
+      or return an object (by reference or by value) for which
       operator -> is in turn overloaded.*/
       inline pointer_type operator->() const {
-          std::abort(); // Not implemented
+          return &static_cast<Node*>(current)->value;
       };
 
   private:
-      ListIterator(const Node*) {
-          // Not implemented
+      friend class List;
+
+      explicit ListIterator(const BaseNode* node) : current(const_cast<BaseNode*>(node)) {
       }
+
   private:
-      Node* current;
+      BaseNode* current = nullptr;
   };
 
 public:
-  List() {
-    // Not implemented
+  List() : List(Allocator()) {
+  }
+
+  explicit List(const Allocator& alloc) : alloc_(alloc) {
+    Reset();
+  }
+
+  explicit List(size_t sz, const Allocator& alloc = Allocator()) : List(alloc) {
+    for (size_t i = 0; i < sz; ++i) {
+      EmplaceAt(&head_);
+    }
   }
 
-  explicit List(size_t /*sz*/) {
-    // Not implemented
+  List(const std::initializer_list<T>& values, const Allocator& alloc = Allocator()) : List(alloc) {
+    for (const T& value : values) {
+      EmplaceAt(&head_, value);
+    }
   }
 
-  List(const std::initializer_list<T>& /*values*/) {
-    // Not implemented
+  List(const List& other)
+      : List(other, NodeTraits::select_on_container_copy_construction(other.alloc_)) {
   }
 
-  List(const List& /*other*/) {
-    // Not implemented
+  List(const List& other, const Allocator& alloc) : List(alloc) {
+    AppendCopy(other);
   }
 
-  List& operator=(const List& /*other*/) {
-    std::abort(); // Not implemented
+  List& operator=(const List& other) {
+    if (this != &other) {
+      Clear();
+      if constexpr (NodeTraits::propagate_on_container_copy_assignment::value) {
+        alloc_ = other.alloc_;
+      }
+      AppendCopy(other);
+    }
+    return *this;
+  }
+
+  List(List&& other) noexcept : alloc_(std::move(other.alloc_)) {
+    Reset();
+    StealNodes(other);
+  }
+
+  List& operator=(List&& other) noexcept(NodeTraits::propagate_on_container_move_assignment::value ||
+                                         NodeTraits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    if constexpr (NodeTraits::propagate_on_container_move_assignment::value) {
+      alloc_ = std::move(other.alloc_);
+    } else if (!(alloc_ == other.alloc_)) {
+      // Our allocator cannot free the other nodes: move the elements instead
+      for (auto it = other.Begin(); it != other.End(); ++it) {
+        EmplaceAt(&head_, std::move(*it));
+      }
+      other.Clear();
+      return *this;
+    }
+    StealNodes(other);
+    return *this;
   }
 
   ListIterator Begin() const noexcept {
-    std::abort(); // Not implemented
+    return ListIterator(head_.next);
   }
 
   ListIterator End() const noexcept {
-    std::abort(); // Not implemented
+    return ListIterator(&head_);
   }
 
   inline T& Front() const {
-    std::abort(); // Not implemented
+    return static_cast<Node*>(head_.next)->value;
   }
 
   inline T& Back() const {
-    std::abort(); // Not implemented
+    return static_cast<Node*>(head_.prev)->value;
   }
 
   inline bool IsEmpty() const noexcept {
-    std::abort(); // Not implemented
+    return size_ == 0;
   }
 
   inline size_t Size() const noexcept {
-    std::abort(); // Not implemented
+    return size_;
+  }
+
+  Allocator GetAllocator() const {
+    return Allocator(alloc_);
+  }
+
+  void Swap(List& other) {
+    if constexpr (NodeTraits::propagate_on_container_swap::value) {
+      std::swap(alloc_, other.alloc_);
+    }
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+    RelinkSentinel();
+    other.RelinkSentinel();
   }
 
-  void Swap(List& /*a*/) {
-    // Not implemented
+  ListIterator Find(const T& value) const {
+    for (auto it = Begin(); it != End(); ++it) {
+      if (*it == value) {
+        return it;
+      }
+    }
+    return End();
   }
 
-  ListIterator Find(const T& /*value*/) const {
-    std::abort(); // Not implemented
+  void Erase(ListIterator pos) {
+    BaseNode* node = pos.current;
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    DestroyNode(static_cast<Node*>(node));
+    --size_;
   }
 
-  void Erase(ListIterator /*pos*/) {
-    // Not implemented
+  void Insert(ListIterator pos, const T& value) {
+    EmplaceAt(pos.current, value);
   }
 
-  void Insert(ListIterator /*pos*/, const T& /*value*/) {
-    // Not implemented
+  void Insert(ListIterator pos, T&& value) {
+    EmplaceAt(pos.current, std::move(value));
+  }
+
+  // Constructs the element from args inside the new node, right before pos
+  template <typename... Args>
+  ListIterator Emplace(ListIterator pos, Args&&... args) {
+    return ListIterator(EmplaceAt(pos.current, std::forward<Args>(args)...));
   }
 
   void Clear() noexcept {
-    // Not implemented
+    BaseNode* node = head_.next;
+    while (node != &head_) {
+      BaseNode* next = node->next;
+      DestroyNode(static_cast<Node*>(node));
+      node = next;
+    }
+    Reset();
+  }
+
+  void PushBack(const T& value) {
+    EmplaceAt(&head_, value);
+  }
+
+  void PushBack(T&& value) {
+    EmplaceAt(&head_, std::move(value));
+  }
+
+  void PushFront(const T& value) {
+    EmplaceAt(head_.next, value);
+  }
+
+  void PushFront(T&& value) {
+    EmplaceAt(head_.next, std::move(value));
   }
 
-  void PushBack(const T& /*value*/) {
-    // Not implemented
+  template <typename... Args>
+  T& EmplaceBack(Args&&... args) {
+    return EmplaceAt(&head_, std::forward<Args>(args)...)->value;
   }
 
-  void PushFront(const T& /*value*/) {
-    // Not implemented
+  template <typename... Args>
+  T& EmplaceFront(Args&&... args) {
+    return EmplaceAt(head_.next, std::forward<Args>(args)...)->value;
   }
 
   void PopBack() {
-    // Not implemented
+    if (IsEmpty()) {
+      throw std::runtime_error("PopBack from an empty list");
+    }
+    Erase(ListIterator(head_.prev));
   }
 
   void PopFront() {
-    // Not implemented
+    if (IsEmpty()) {
+      throw std::runtime_error("PopFront from an empty list");
+    }
+    Erase(Begin());
+  }
+
+  // Moves all the elements of other before pos in O(1) by relinking its nodes.
+  // If the allocators differ, our allocator cannot free the other nodes, so
+  // the elements are moved into new nodes instead.
+  void Splice(ListIterator pos, List& other) {
+    if (&other == this || other.IsEmpty()) {
+      return;
+    }
+    if (!CanAdopt(other)) {
+      Splice(pos, other, other.Begin(), other.End());
+      return;
+    }
+    BaseNode* first = other.head_.next;
+    BaseNode* last = other.head_.prev;
+    size_ += other.size_;
+    other.Reset();
+    LinkBefore(pos.current, first, last);
+  }
+
+  // Moves [first, last) of other before pos. Only the length of the range is
+  // counted, to keep both sizes right; within one list nothing is counted.
+  // pos must not be strictly inside [first, last); at either end it is a no-op.
+  void Splice(ListIterator pos, List& other, ListIterator first, ListIterator last) {
+    if (first == last || pos == first || pos == last) {
+      return;
+    }
+    if (!CanAdopt(other)) {
+      while (first != last) {
+        EmplaceAt(pos.current, std::move(*first));
+        other.Erase(first++);
+      }
+      return;
+    }
+    if (&other != this) {
+      auto count = static_cast<size_t>(std::distance(first, last));
+      other.size_ -= count;
+      size_ += count;
+    }
+    BaseNode* head = first.current;
+    BaseNode* tail = last.current->prev;
+    head->prev->next = last.current;
+    last.current->prev = head->prev;
+    LinkBefore(pos.current, head, tail);
+  }
+
+  // Merges other, sorted by comp, into this list, also sorted by comp. The
+  // nodes of other are relinked, and on equal elements ours go first.
+  template <typename Compare>
+  void Merge(List& other, Compare comp) {
+    if (&other == this) {
+      return;
+    }
+    BaseNode* pos = head_.next;
+    while (!other.IsEmpty()) {
+      BaseNode* node = other.head_.next;
+      if (pos != &head_ && !comp(static_cast<Node*>(node)->value, static_cast<Node*>(pos)->value)) {
+        pos = pos->next;
+        continue;
+      }
+      if (pos == &head_) {
+        Splice(End(), other);
+        return;
+      }
+      Splice(ListIterator(pos), other, ListIterator(node), ListIterator(node->next));
+    }
+  }
+
+  void Merge(List& other) {
+    Merge(other, std::less<T>());
+  }
+
+  // Stable bottom-up merge sort that only relinks nodes. runs[k] holds a sorted
+  // run of 2^k nodes or nothing, like a digit of a binary counter: every node
+  // enters as a run of one and is carried up through the occupied levels. The
+  // only extra memory is that array of run heads. If comp throws, all the
+  // elements stay in the list in an unspecified order.
+  template <typename Compare>
+  void Sort(Compare comp) {
+    if (size_ < 2) {
+      return;
+    }
+    BaseNode* runs[std::numeric_limits<size_t>::digits] = {};
+    size_t levels = 0;
+    head_.prev->next = nullptr;
+    BaseNode* rest = head_.next;
+    BaseNode* carry = nullptr;
+    try {
+      while (rest != nullptr) {
+        carry = rest;
+        rest = rest->next;
+        carry->next = nullptr;
+        carry->prev = carry;
+        size_t level = 0;
+        for (; runs[level] != nullptr; ++level) {
+          // Runs already in the counter hold earlier elements, so they go on the left
+          MergeRuns(runs[level], std::exchange(carry, nullptr), comp);
+          carry = std::exchange(runs[level], nullptr);
+        }
+        runs[level] = std::exchange(carry, nullptr);
+        levels = std::max(levels, level + 1);
+      }
+      for (size_t level = 0; level < levels; ++level) {
+        if (runs[level] == nullptr) {
+          continue;
+        }
+        if (carry != nullptr) {
+          MergeRuns(runs[level], std::exchange(carry, nullptr), comp);
+        }
+        carry = std::exchange(runs[level], nullptr);
+      }
+    } catch (...) {
+      BaseNode* chain = nullptr;
+      BaseNode** tail = &chain;
+      auto append = [&tail](BaseNode* run) {
+        *tail = run;
+        while (*tail != nullptr) {
+          tail = &(*tail)->next;
+        }
+      };
+      for (size_t level = levels; level-- > 0;) {
+        append(runs[level]);
+      }
+      append(carry);
+      append(rest);
+      RelinkChain(chain);
+      throw;
+    }
+    BaseNode* last = carry->prev;
+    head_.next = carry;
+    carry->prev = &head_;
+    head_.prev = last;
+    last->next = &head_;
+  }
+
+  void Sort() {
+    Sort(std::less<T>());
   }
 
   ~List() {
-    // Not implemented
+    Clear();
+  }
+
+private:
+  // Empty state: the sentinel points to itself
+  void Reset() noexcept {
+    head_.prev = &head_;
+    head_.next = &head_;
+    size_ = 0;
+  }
+
+  // Constructs a node from args and links it right before pos
+  template <typename... Args>
+  Node* EmplaceAt(BaseNode* pos, Args&&... args) {
+    Node* node = NodeTraits::allocate(alloc_, 1);
+    try {
+      NodeTraits::construct(alloc_, node, std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(alloc_, node, 1);
+      throw;
+    }
+    node->prev = pos->prev;
+    node->next = pos;
+    pos->prev->next = node;
+    pos->prev = node;
+    ++size_;
+    return node;
+  }
+
+  void DestroyNode(Node* node) noexcept {
+    NodeTraits::destroy(alloc_, node);
+    NodeTraits::deallocate(alloc_, node, 1);
+  }
+
+  // Whether our allocator can free the nodes of other
+  bool CanAdopt(const List& other) const noexcept {
+    return NodeTraits::is_always_equal::value || alloc_ == other.alloc_;
+  }
+
+  // Links the chain first..last, whose own outer links are stale, right before pos
+  static void LinkBefore(BaseNode* pos, BaseNode* first, BaseNode* last) noexcept {
+    first->prev = pos->prev;
+    last->next = pos;
+    pos->prev->next = first;
+    pos->prev = last;
+  }
+
+  // Merges the sorted run right into the sorted run left, taking from left on
+  // ties. A run is a null-terminated chain with valid prev links, except that
+  // the prev of its first node points to its last one. Links change only where
+  // the merge switches runs, so nodes that keep their neighbours are not
+  // written to. If comp throws, left still holds every node of both runs.
+  template <typename Compare>
+  static void MergeRuns(BaseNode*& left, BaseNode* right, Compare& comp) {
+    BaseNode* a = left;
+    BaseNode* b = right;
+    BaseNode* a_last = a->prev;
+    BaseNode* b_last = b->prev;
+    BaseNode before{nullptr, a};
+    BaseNode* last = &before;
+    auto link = [](BaseNode* prev, BaseNode* next) {
+      prev->next = next;
+      next->prev = prev;
+    };
+    auto finish = [&](BaseNode* run_last) {
+      left = before.next;
+      left->prev = run_last;
+    };
+    try {
+      while (true) {
+        while (!comp(static_cast<Node*>(b)->value, static_cast<Node*>(a)->value)) {
+          last = a;
+          if ((a = a->next) == nullptr) {
+            link(last, b);
+            finish(b_last);
+            return;
+          }
+        }
+        link(last, b);
+        do {
+          last = b;
+          if ((b = b->next) == nullptr) {
+            link(last, a);
+            finish(a_last);
+            return;
+          }
+        } while (comp(static_cast<Node*>(b)->value, static_cast<Node*>(a)->value));
+        link(last, a);
+      }
+    } catch (...) {
+      link(last, a);
+      link(a_last, b);
+      finish(b_last);
+      throw;
+    }
+  }
+
+  // Links the null-terminated chain of all our nodes between the sentinel's ends, rebuilding prev
+  void RelinkChain(BaseNode* first) noexcept {
+    BaseNode* prev = &head_;
+    for (BaseNode* node = first; node != nullptr; node = node->next) {
+      node->prev = prev;
+      prev->next = node;
+      prev = node;
+    }
+    prev->next = &head_;
+    head_.prev = prev;
+  }
+
+  void AppendCopy(const List& other) {
+    for (auto it = other.Begin(); it != other.End(); ++it) {
+      EmplaceAt(&head_, *it);
+    }
+  }
+
+  // Points the first and the last node back to our sentinel after head_ was copied from another list
+  void RelinkSentinel() noexcept {
+    if (size_ == 0) {
+      Reset();
+      return;
+    }
+    head_.next->prev = &head_;
+    head_.prev->next = &head_;
+  }
+
+  // Takes all the nodes of other, which must be allocated compatibly; this list must be empty
+  void StealNodes(List& other) noexcept {
+    head_ = other.head_;
+    size_ = other.size_;
+    RelinkSentinel();
+    other.Reset();
   }
 
 private:
-  /*???*/
+  BaseNode head_;
+  size_t size_;
+  [[no_unique_address]] NodeAllocator alloc_;
 };
 
 
 namespace std {
   // Global swap overloading
-  template <typename T>
-  void swap(List<T>& a, List<T>& b) {
+  template <typename T, typename Allocator>
+  void swap(List<T, Allocator>& a, List<T, Allocator>& b) {
     a.Swap(b);
   }
 }
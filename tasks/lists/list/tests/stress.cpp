@@ -1,11 +1,14 @@
 #include <random>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
 
 #include "../list.hpp"
+#include "../unrolled_list.hpp"
+#include "../intrusive_list.hpp"
 
 void ConstructRandomList(List<int>& list, int sz) {
   std::random_device rd;
@@ -19,6 +22,18 @@ void ConstructRandomList(List<int>& list, int sz) {
   }
 }
 
+void ConstructRandomList(UnrolledList<int>& list, int sz) {
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  int random_key;
+  while(sz) {
+    random_key = dist(mt);
+    list.PushBack(random_key);
+    --sz;
+  }
+}
+
 void ConstructRandomList(std::list<int>& list, int sz) {
   std::random_device rd;
   std::mt19937 mt(rd());
@@ -40,6 +55,14 @@ void BM_CustomListPushBack(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+void BM_UnrolledListPushBack(benchmark::State& state) {
+  UnrolledList<int> list;
+  for (auto _ : state) {
+    ConstructRandomList(list, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
 void BM_StdListPushBack(benchmark::State& state) {
   std::list<int> list;
   for (auto _ : state) {
@@ -105,6 +128,15 @@ void BM_CustomListClear(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+void BM_UnrolledListClear(benchmark::State& state) {
+  UnrolledList<int> list;
+  for (auto _ : state) {
+    ConstructRandomList(list, state.range(0));
+    list.Clear();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
 void BM_StdListClear(benchmark::State& state) {
   std::list<int> list;
   for (auto _ : state) {
@@ -123,7 +155,21 @@ void BM_CustomListFind(benchmark::State& state) {
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     random_key = dist(mt);
-    list.Find(random_key);
+    benchmark::DoNotOptimize(list.Find(random_key));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_UnrolledListFind(benchmark::State& state) {
+  UnrolledList<int> list;
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  int random_key;
+  for (auto _ : state) {
+    ConstructRandomList(list, state.range(0));
+    random_key = dist(mt);
+    benchmark::DoNotOptimize(list.Find(random_key));
   }
   state.SetComplexityN(state.range(0));
 }
@@ -137,22 +183,302 @@ void BM_StdListFind(benchmark::State& state) {
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     random_key = dist(mt);
-    std::ignore = std::find(list.begin(), list.end(), random_key);
+    benchmark::DoNotOptimize(std::find(list.begin(), list.end(), random_key));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+// Find on a list of range(0) elements built once; the key is absent, so the whole list is walked
+template <typename L>
+void BM_FindScan(benchmark::State& state) {
+  L list;
+  for (int i = 0; i < state.range(0); ++i) {
+    list.PushBack(i);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(list.Find(-1));
   }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
+// How a std::string the caller has just built reaches the node
+enum class Pass {
+  Copy,
+  Move,
+  Emplace,
+};
+
+// Longer than the small string buffer, so every copy allocates
+const std::string payload(64, 'x');
+
+template <Pass P>
+void BM_CustomListStringPushBack(benchmark::State& state) {
+  List<std::string> list;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      if constexpr (P == Pass::Copy) {
+        std::string value(payload);
+        list.PushBack(value);
+      } else if constexpr (P == Pass::Move) {
+        std::string value(payload);
+        list.PushBack(std::move(value));
+      } else {
+        list.EmplaceBack(payload);
+      }
+    }
+    list.Clear();
+  }
+  state.counters["time/op"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * state.range(0)), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+// Two queues of range(0) elements; each iteration moves the whole of one to
+// the back of the other, as a scheduler handing work between queues would
+void BM_CustomListSpliceAll(benchmark::State& state) {
+  List<int> from;
+  List<int> to;
+  ConstructRandomList(from, state.range(0));
+  for (auto _ : state) {
+    to.Splice(to.End(), from);
+    std::swap(from, to);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdListSpliceAll(benchmark::State& state) {
+  std::list<int> from;
+  std::list<int> to;
+  ConstructRandomList(from, state.range(0));
+  for (auto _ : state) {
+    to.splice(to.end(), from);
+    std::swap(from, to);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The same hand-over done element by element: one free and one malloc each
+void BM_CustomListMoveEach(benchmark::State& state) {
+  List<int> from;
+  List<int> to;
+  ConstructRandomList(from, state.range(0));
+  for (auto _ : state) {
+    while (!from.IsEmpty()) {
+      to.PushBack(from.Front());
+      from.PopFront();
+    }
+    std::swap(from, to);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Moves the first half of a queue into an empty one; the range is counted for
+// Size(). Refilling the queue and finding its middle are not timed.
+void BM_CustomListSpliceHalf(benchmark::State& state) {
+  List<int> from;
+  List<int> to;
+  ConstructRandomList(from, state.range(0));
+  int64_t moved = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    from.Splice(from.End(), to);
+    auto middle = from.Begin();
+    std::advance(middle, state.range(0) / 2);
+    state.ResumeTiming();
+    to.Splice(to.End(), from, from.Begin(), middle);
+    moved += to.Size();
+  }
+  state.SetItemsProcessed(moved);
+}
+
+void BM_StdListSpliceHalf(benchmark::State& state) {
+  std::list<int> from;
+  std::list<int> to;
+  ConstructRandomList(from, state.range(0));
+  int64_t moved = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    from.splice(from.end(), to);
+    auto middle = from.begin();
+    std::advance(middle, state.range(0) / 2);
+    state.ResumeTiming();
+    to.splice(to.end(), from, from.begin(), middle);
+    moved += to.size();
+  }
+  state.SetItemsProcessed(moved);
+}
+
+
+// LRU cache of range(0) entries: each touch moves a random entry to the front
+struct LruEntry : IntrusiveListHook<> {
+  int key = 0;
+  List<LruEntry*>::ListIterator position;
+};
+
+std::vector<int> RandomTouches(int entries) {
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, entries - 1);
+  std::vector<int> touches(1 << 16);
+  for (int& touch : touches) {
+    touch = dist(mt);
+  }
+  return touches;
+}
+
+void BM_IntrusiveListLruTouch(benchmark::State& state) {
+  std::vector<LruEntry> entries(state.range(0));
+  IntrusiveList<LruEntry> lru;
+  for (auto& entry : entries) {
+    lru.PushBack(entry);
+  }
+  std::vector<int> touches = RandomTouches(state.range(0));
+  for (auto _ : state) {
+    for (int touch : touches) {
+      LruEntry& entry = entries[touch];
+      lru.Erase(entry);
+      lru.PushFront(entry);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * touches.size());
+}
+
+// List<T*> with each entry remembering its node: a touch frees and allocates a node
+void BM_PointerListLruTouch(benchmark::State& state) {
+  std::vector<LruEntry> entries(state.range(0));
+  List<LruEntry*> lru;
+  for (auto& entry : entries) {
+    lru.PushBack(&entry);
+    entry.position = --lru.End();
+  }
+  std::vector<int> touches = RandomTouches(state.range(0));
+  for (auto _ : state) {
+    for (int touch : touches) {
+      LruEntry& entry = entries[touch];
+      lru.Erase(entry.position);
+      lru.PushFront(&entry);
+      entry.position = lru.Begin();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * touches.size());
+}
+
+// The same, but the node is relinked with Splice and nothing is allocated
+void BM_PointerListLruSplice(benchmark::State& state) {
+  std::vector<LruEntry> entries(state.range(0));
+  List<LruEntry*> lru;
+  for (auto& entry : entries) {
+    lru.PushBack(&entry);
+    entry.position = --lru.End();
+  }
+  std::vector<int> touches = RandomTouches(state.range(0));
+  for (auto _ : state) {
+    for (int touch : touches) {
+      auto position = entries[touch].position;
+      lru.Splice(lru.Begin(), lru, position, std::next(position));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * touches.size());
+}
+
+
+enum class SortInput {
+  Random,
+  Sorted,
+  Reversed,
+  FewUnique,
+};
+
+std::vector<int> SortKeys(SortInput input, int size) {
+  std::mt19937 mt(42);
+  std::vector<int> keys(size);
+  for (int i = 0; i < size; ++i) {
+    switch (input) {
+      case SortInput::Random:
+        keys[i] = static_cast<int>(mt());
+        break;
+      case SortInput::Sorted:
+        keys[i] = i;
+        break;
+      case SortInput::Reversed:
+        keys[i] = size - i;
+        break;
+      case SortInput::FewUnique:
+        keys[i] = static_cast<int>(mt() % 16);
+        break;
+    }
+  }
+  return keys;
+}
+
+// Only the sort is timed; the list is rebuilt from the same keys before each one
+template <SortInput Input>
+void BM_CustomListSort(benchmark::State& state) {
+  std::vector<int> keys = SortKeys(Input, state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    List<int> list;
+    for (int key : keys) {
+      list.PushBack(key);
+    }
+    state.ResumeTiming();
+    list.Sort();
+    state.PauseTiming();
+    list.Clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <SortInput Input>
+void BM_StdListSort(benchmark::State& state) {
+  std::vector<int> keys = SortKeys(Input, state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::list<int> list(keys.begin(), keys.end());
+    state.ResumeTiming();
+    list.sort();
+    state.PauseTiming();
+    list.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 
 BENCHMARK(BM_CustomListPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_UnrolledListPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomListStringPushBack, Pass::Copy)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_CustomListStringPushBack, Pass::Move)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_CustomListStringPushBack, Pass::Emplace)->Range(1<<10, 1<<16);
 BENCHMARK(BM_CustomListMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_UnrolledListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_UnrolledListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_FindScan, List<int>)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK_TEMPLATE(BM_FindScan, UnrolledList<int>)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_CustomListSpliceAll)->Arg(1<<20);
+BENCHMARK(BM_StdListSpliceAll)->Arg(1<<20);
+BENCHMARK(BM_CustomListMoveEach)->Arg(1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListSpliceHalf)->Arg(1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListSpliceHalf)->Arg(1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IntrusiveListLruTouch)->RangeMultiplier(16)->Range(1<<10, 1<<20);
+BENCHMARK(BM_PointerListLruTouch)->RangeMultiplier(16)->Range(1<<10, 1<<20);
+BENCHMARK(BM_PointerListLruSplice)->RangeMultiplier(16)->Range(1<<10, 1<<20);
+BENCHMARK_TEMPLATE(BM_CustomListSort, SortInput::Random)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdListSort, SortInput::Random)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomListSort, SortInput::Sorted)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdListSort, SortInput::Sorted)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomListSort, SortInput::Reversed)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdListSort, SortInput::Reversed)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomListSort, SortInput::FewUnique)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdListSort, SortInput::FewUnique)->RangeMultiplier(16)->Range(1<<10, 1<<22)->Unit(benchmark::kMillisecond);
 
 
 BENCHMARK_MAIN();
\ No newline at end of file
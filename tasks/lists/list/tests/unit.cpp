@@ -1,11 +1,17 @@
 #include <list>
+#include <memory>
+#include <random>
+#include <string>
 #include <thread>
+#include <vector>
 #include <future>
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
 #include "../list.hpp"
+#include "../unrolled_list.hpp"
+#include "../intrusive_list.hpp"
 
 class ListTest: public testing::Test {
   protected:
@@ -154,7 +160,7 @@ TEST_F(ListTest, SelfAssignment) {
   auto future = std::async(std::launch::async, &std::thread::join, &thread);
   ASSERT_EQ(
     future.wait_for(std::chrono::seconds(1)),
-    std::future_status::timeout
+    std::future_status::ready
   ) << "There is infinity loop!\n";
 }
 
@@ -180,18 +186,20 @@ TEST_F(ListTest, ReverseRangeWithIteratorPreFix) {
   ASSERT_EQ(std::distance(list.Begin(), list.End()), sz) << 
                 "Distanse between begin and end iterators ins't equal size";
   int iter = sz;
-  for (auto it = list.End(); it != list.Begin(); --it) {
-    ASSERT_EQ(*it, iter--);
+  for (auto it = list.End(); it != list.Begin();) {
+    ASSERT_EQ(*--it, iter--);
   }
+  ASSERT_EQ(iter, 0);
 }
 
 TEST_F(ListTest, ReverseRangeWithIteratorPostFix) {
   ASSERT_EQ(std::distance(list.Begin(), list.End()), sz) << 
                 "Distanse between begin and end iterators ins't equal size";
   int iter = sz;
-  for (auto it = list.End(); it != list.Begin(); it--) {
+  for (auto it = list.End(); it-- != list.Begin();) {
     ASSERT_EQ(*it, iter--);
   }
+  ASSERT_EQ(iter, 0);
 }
 
 TEST_F(ListTest, EraseBegin) {
@@ -230,6 +238,424 @@ TEST_F(ListTest, Clear) {
 }
 
 
+TEST(ListEmplaceTest, MoveOnlyValues) {
+  List<std::unique_ptr<int>> list;
+  list.PushBack(std::make_unique<int>(2));
+  list.PushFront(std::make_unique<int>(1));
+  list.Insert(list.End(), std::make_unique<int>(4));
+  auto it = list.Emplace(--list.End(), new int(3));
+  ASSERT_EQ(**it, 3);
+  int expected = 1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(**it, expected++);
+  }
+  ASSERT_EQ(list.Size(), 4);
+}
+
+TEST(ListEmplaceTest, ConstructsInPlace) {
+  List<std::string> list;
+  std::string& back = list.EmplaceBack(3, 'b');
+  std::string& front = list.EmplaceFront("front");
+  ASSERT_EQ(back, "bbb");
+  ASSERT_EQ(&front, &list.Front());
+  std::string moved = "moved into the node, long enough to live on the heap";
+  const char* buffer = moved.data();
+  list.PushBack(std::move(moved));
+  ASSERT_EQ(list.Back().data(), buffer);
+}
+
+TEST(ListSpliceTest, WholeList) {
+  List<int> list{1, 4};
+  List<int> other{2, 3};
+  auto moved = other.Begin();
+  list.Splice(++list.Begin(), other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(other.Begin(), other.End());
+  ASSERT_EQ(list.Size(), 4);
+  ASSERT_EQ(*moved, 2);
+  int expected = 1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+  list.Splice(list.End(), other);
+  ASSERT_EQ(list.Size(), 4);
+}
+
+TEST(ListSpliceTest, RangeFromAnotherList) {
+  List<int> list{1, 5};
+  List<int> other{0, 2, 3, 4, 6};
+  auto first = ++other.Begin();
+  auto last = first;
+  std::advance(last, 3);
+  list.Splice(--list.End(), other, first, last);
+  ASSERT_EQ(list.Size(), 5);
+  ASSERT_EQ(other.Size(), 2);
+  ASSERT_EQ(other.Front(), 0);
+  ASSERT_EQ(other.Back(), 6);
+  int expected = 1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+  for (auto it = list.End(); it != list.Begin();) {
+    ASSERT_EQ(*--it, --expected);
+  }
+}
+
+TEST(ListSpliceTest, RangeWithinOneList) {
+  List<int> list{3, 4, 1, 2};
+  auto first = list.Begin();
+  std::advance(first, 2);
+  list.Splice(list.Begin(), list, first, list.End());
+  ASSERT_EQ(list.Size(), 4);
+  int expected = 1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+  ASSERT_EQ(list.Back(), 4);
+  list.Splice(list.Begin(), list, list.Begin(), ++list.Begin());
+  ASSERT_EQ(list.Front(), 1);
+  ASSERT_EQ(list.Size(), 4);
+}
+
+TEST(ListMergeTest, MergesSortedListsStably) {
+  using Item = std::pair<int, char>;
+  auto by_key = [](const Item& a, const Item& b) {
+    return a.first < b.first;
+  };
+  List<Item> list{{1, 'a'}, {3, 'a'}, {3, 'b'}, {7, 'a'}};
+  List<Item> other{{0, 'c'}, {3, 'c'}, {5, 'c'}, {8, 'c'}, {9, 'c'}};
+  list.Merge(other, by_key);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(list.Size(), 9);
+  List<Item> expected{{0, 'c'}, {1, 'a'}, {3, 'a'}, {3, 'b'}, {3, 'c'}, {5, 'c'}, {7, 'a'}, {8, 'c'}, {9, 'c'}};
+  auto it = list.Begin();
+  for (auto expected_it = expected.Begin(); expected_it != expected.End(); ++expected_it, ++it) {
+    ASSERT_EQ(*it, *expected_it);
+  }
+  ASSERT_EQ(*--list.End(), (Item{9, 'c'}));
+}
+
+TEST(ListMergeTest, DefaultComparator) {
+  List<int> list;
+  List<int> other{1, 2, 3};
+  list.Merge(other);
+  ASSERT_EQ(list.Size(), 3);
+  list.Merge(list);
+  ASSERT_EQ(list.Size(), 3);
+  ASSERT_EQ(list.Front(), 1);
+}
+
+TEST(ListSortTest, MatchesStdListSort) {
+  std::mt19937 mt(11);
+  for (int size : {0, 1, 2, 3, 7, 64, 1000, 4097}) {
+    List<int> list;
+    std::list<int> expected;
+    for (int i = 0; i < size; ++i) {
+      int value = static_cast<int>(mt() % 100);
+      list.PushBack(value);
+      expected.push_back(value);
+    }
+    list.Sort();
+    expected.sort();
+    ASSERT_EQ(list.Size(), expected.size());
+    auto expected_it = expected.begin();
+    for (auto it = list.Begin(); it != list.End(); ++it, ++expected_it) {
+      ASSERT_EQ(*it, *expected_it);
+    }
+    auto reverse_it = expected.rbegin();
+    for (auto it = list.End(); it != list.Begin(); ++reverse_it) {
+      ASSERT_EQ(*--it, *reverse_it);
+    }
+  }
+}
+
+TEST(ListSortTest, IsStable) {
+  using Item = std::pair<int, int>;
+  List<Item> list;
+  for (int i = 0; i < 1000; ++i) {
+    list.PushBack({(i * 7919) % 10, i});
+  }
+  list.Sort([](const Item& a, const Item& b) {
+    return a.first < b.first;
+  });
+  auto prev = list.Begin();
+  for (auto it = ++list.Begin(); it != list.End(); prev = it++) {
+    ASSERT_TRUE(prev->first < it->first || (prev->first == it->first && prev->second < it->second));
+  }
+}
+
+TEST(ListSortTest, DescendingAndIteratorsStayValid) {
+  List<int> list{3, 1, 4, 1, 5, 9, 2, 6};
+  auto nine = list.Find(9);
+  list.Sort(std::greater<int>());
+  ASSERT_EQ(list.Begin(), nine);
+  ASSERT_EQ(list.Front(), 9);
+  ASSERT_EQ(list.Back(), 1);
+}
+
+TEST(ListSortTest, ThrowingComparatorKeepsAllElements) {
+  List<int> list;
+  for (int i = 0; i < 100; ++i) {
+    list.PushBack((i * 37) % 100);
+  }
+  int calls = 0;
+  ASSERT_THROW(list.Sort([&calls](int a, int b) {
+    if (++calls == 300) {
+      throw std::runtime_error("comparison failed");
+    }
+    return a < b;
+  }), std::runtime_error);
+  ASSERT_EQ(list.Size(), 100);
+  std::vector<bool> seen(100);
+  size_t count = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it, ++count) {
+    ASSERT_FALSE(seen[*it]);
+    seen[*it] = true;
+  }
+  ASSERT_EQ(count, 100);
+  for (auto it = list.End(); it != list.Begin(); --count) {
+    --it;
+  }
+  ASSERT_EQ(count, 0);
+  list.Sort();
+  ASSERT_EQ(list.Front(), 0);
+  ASSERT_EQ(list.Back(), 99);
+}
+
+struct Job : IntrusiveListHook<>, IntrusiveListHook<struct ByPriority, HookMode::Safe> {
+  explicit Job(int id) : id(id) {
+  }
+
+  bool operator==(const Job& other) const {
+    return id == other.id;
+  }
+
+  int id;
+};
+
+using PriorityHook = IntrusiveListHook<ByPriority, HookMode::Safe>;
+
+TEST(IntrusiveListTest, LinksObjectsInPlace) {
+  Job a(1), b(2), c(3);
+  IntrusiveList<Job> list;
+  list.PushBack(b);
+  list.PushFront(a);
+  list.Insert(list.End(), c);
+  ASSERT_EQ(list.Size(), 3);
+  ASSERT_EQ(&list.Front(), &a);
+  ASSERT_EQ(&list.Back(), &c);
+  int expected = 1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(it->id, expected++);
+  }
+  for (auto it = list.End(); it != list.Begin();) {
+    ASSERT_EQ((*--it).id, --expected);
+  }
+  ASSERT_EQ(list.Find(Job(2)), list.IteratorTo(b));
+}
+
+TEST(IntrusiveListTest, UnlinksFromTheObject) {
+  Job a(1), b(2), c(3);
+  IntrusiveList<Job> list;
+  list.PushBack(a);
+  list.PushBack(b);
+  list.PushBack(c);
+  list.Erase(b);
+  ASSERT_EQ(list.Size(), 2);
+  ASSERT_EQ(&*++list.Begin(), &c);
+  list.PushFront(b);
+  ASSERT_EQ(&list.Front(), &b);
+  list.PopBack();
+  list.PopFront();
+  ASSERT_EQ(list.Size(), 1);
+  ASSERT_EQ(&list.Front(), &a);
+  list.Clear();
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_THROW(list.PopFront(), std::runtime_error);
+}
+
+TEST(IntrusiveListTest, OneObjectInTwoLists) {
+  Job a(1), b(2);
+  IntrusiveList<Job> queue;
+  IntrusiveList<Job, PriorityHook> priorities;
+  queue.PushBack(a);
+  queue.PushBack(b);
+  priorities.PushBack(b);
+  priorities.PushBack(a);
+  ASSERT_EQ(queue.Front().id, 1);
+  ASSERT_EQ(priorities.Front().id, 2);
+  queue.Erase(a);
+  ASSERT_EQ(priorities.Size(), 2);
+  ASSERT_EQ(priorities.Back().id, 1);
+}
+
+TEST(IntrusiveListTest, SafeHooksDetectDoubleInsertion) {
+  Job a(1);
+  IntrusiveList<Job, PriorityHook> list;
+  IntrusiveList<Job, PriorityHook> other;
+  ASSERT_FALSE(static_cast<PriorityHook&>(a).IsLinked());
+  list.PushBack(a);
+  ASSERT_TRUE(static_cast<PriorityHook&>(a).IsLinked());
+  ASSERT_THROW(list.PushBack(a), std::logic_error);
+  ASSERT_THROW(other.PushFront(a), std::logic_error);
+  ASSERT_EQ(list.Size(), 1);
+  Job copy = a;
+  ASSERT_FALSE(static_cast<PriorityHook&>(copy).IsLinked());
+  list.Erase(a);
+  ASSERT_FALSE(static_cast<PriorityHook&>(a).IsLinked());
+  other.PushBack(a);
+  other.Clear();
+  ASSERT_FALSE(static_cast<PriorityHook&>(a).IsLinked());
+}
+
+TEST(IntrusiveListTest, MoveAndSwap) {
+  Job a(1), b(2), c(3);
+  IntrusiveList<Job> list;
+  list.PushBack(a);
+  list.PushBack(b);
+  IntrusiveList<Job> moved = std::move(list);
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(list.Begin(), list.End());
+  ASSERT_EQ(moved.Size(), 2);
+  list.PushBack(c);
+  list.Swap(moved);
+  ASSERT_EQ(list.Size(), 2);
+  ASSERT_EQ(moved.Size(), 1);
+  ASSERT_EQ(&*--list.End(), &b);
+  ASSERT_EQ(&*moved.Begin(), &c);
+}
+
+// Four elements per node, so a handful of operations already splits and merges nodes
+using SmallUnrolledList = UnrolledList<int, 4>;
+
+template <typename L>
+std::list<int> ToStd(const L& list) {
+  std::list<int> result;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    result.push_back(*it);
+  }
+  return result;
+}
+
+TEST(UnrolledListTest, PushBackAndFront) {
+  SmallUnrolledList list;
+  for (int i = 0; i < 10; ++i) {
+    list.PushBack(i);
+    list.PushFront(-i - 1);
+  }
+  ASSERT_EQ(list.Size(), 20);
+  ASSERT_EQ(list.Front(), -10);
+  ASSERT_EQ(list.Back(), 9);
+  std::list<int> expected;
+  for (int i = -10; i < 10; ++i) {
+    expected.push_back(i);
+  }
+  ASSERT_EQ(ToStd(list), expected);
+}
+
+TEST(UnrolledListTest, ReverseIteration) {
+  SmallUnrolledList list{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  int expected = 9;
+  for (auto it = list.End(); it != list.Begin();) {
+    --it;
+    ASSERT_EQ(*it, expected--);
+  }
+  ASSERT_EQ(expected, 0);
+}
+
+TEST(UnrolledListTest, InsertIntoFullNodeSplitsIt) {
+  SmallUnrolledList list{1, 2, 3, 4};
+  auto it = list.Begin();
+  std::advance(it, 2);
+  list.Insert(it, 10);
+  ASSERT_EQ(ToStd(list), (std::list<int>{1, 2, 10, 3, 4}));
+  list.Insert(list.Begin(), 0);
+  list.Insert(list.End(), 5);
+  ASSERT_EQ(ToStd(list), (std::list<int>{0, 1, 2, 10, 3, 4, 5}));
+  ASSERT_EQ(list.Size(), 7);
+}
+
+TEST(UnrolledListTest, EraseMergesSparseNodes) {
+  SmallUnrolledList list{1, 2, 3, 4, 5, 6, 7, 8};
+  list.Erase(list.Find(2));
+  list.Erase(list.Find(3));
+  list.Erase(list.Find(4));
+  ASSERT_EQ(ToStd(list), (std::list<int>{1, 5, 6, 7, 8}));
+  while (!list.IsEmpty()) {
+    list.PopBack();
+  }
+  ASSERT_EQ(list.Begin(), list.End());
+  ASSERT_THROW(list.PopFront(), std::runtime_error);
+}
+
+TEST(UnrolledListTest, FindMissing) {
+  SmallUnrolledList list{1, 2, 3, 4, 5};
+  ASSERT_EQ(list.Find(6), list.End());
+  ASSERT_EQ(*list.Find(5), 5);
+}
+
+TEST(UnrolledListTest, CopyMoveAndSwap) {
+  UnrolledList<std::string, 3> list{"a", "b", "c", "d", "e"};
+  auto copy = list;
+  ASSERT_EQ(copy.Size(), 5);
+  ASSERT_EQ(copy.Back(), "e");
+  auto moved = std::move(copy);
+  ASSERT_TRUE(copy.IsEmpty());
+  ASSERT_EQ(moved.Front(), "a");
+  UnrolledList<std::string, 3> other{"x"};
+  moved.Swap(other);
+  ASSERT_EQ(moved.Size(), 1);
+  ASSERT_EQ(other.Size(), 5);
+  ASSERT_EQ(*--other.End(), "e");
+  other = moved;
+  ASSERT_EQ(other.Front(), "x");
+}
+
+TEST(UnrolledListTest, EmplaceAndMove) {
+  UnrolledList<std::unique_ptr<int>, 4> list;
+  for (int i = 0; i < 8; i += 2) {
+    list.PushBack(std::make_unique<int>(i));
+  }
+  for (int i = 7; i > 0; i -= 2) {
+    auto pos = list.Begin();
+    std::advance(pos, (i + 1) / 2);
+    auto it = list.Emplace(pos, new int(i));
+    ASSERT_EQ(**it, i);
+  }
+  list.EmplaceFront(new int(-1));
+  ASSERT_EQ(*list.EmplaceBack(new int(8)), 8);
+  int expected = -1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(**it, expected++);
+  }
+  ASSERT_EQ(list.Size(), 10);
+}
+
+TEST(UnrolledListTest, MatchesListOnRandomEdits) {
+  std::mt19937 mt(7);
+  SmallUnrolledList unrolled;
+  std::list<int> model;
+  for (int step = 0; step < 5000; ++step) {
+    size_t pos = model.empty() ? 0 : mt() % (model.size() + 1);
+    auto it = unrolled.Begin();
+    auto model_it = model.begin();
+    std::advance(it, pos);
+    std::advance(model_it, pos);
+    if (mt() % 3 != 0 || model_it == model.end()) {
+      unrolled.Insert(it, step);
+      model.insert(model_it, step);
+    } else {
+      unrolled.Erase(it);
+      model.erase(model_it);
+    }
+    ASSERT_EQ(unrolled.Size(), model.size());
+  }
+  ASSERT_EQ(ToStd(unrolled), model);
+  unrolled.Clear();
+  ASSERT_TRUE(unrolled.IsEmpty());
+}
+
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -0,0 +1,482 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Elements per node of UnrolledList: about two cache lines of payload, at least 4
+template <typename T>
+inline constexpr size_t DefaultUnrolledCapacity = std::max<size_t>(4, 128 / sizeof(T));
+
+// Doubly linked list whose nodes hold up to NodeCapacity elements in a small
+// array, so a walk touches one node per NodeCapacity elements and one
+// allocation is shared by them. Inserting into a full node splits it in two
+// halves; a node that falls below half capacity after an erase absorbs its
+// next neighbour when both fit into one node.
+//
+// Insert and Erase shift at most NodeCapacity elements, so they are O(1), but
+// unlike List they invalidate iterators to the elements of the nodes involved.
+template <typename T, size_t NodeCapacity = DefaultUnrolledCapacity<T>, typename Allocator = std::allocator<T>>
+class UnrolledList {
+  static_assert(NodeCapacity >= 2, "a node must hold at least two elements to be split");
+
+private:
+  struct BaseNode {
+    BaseNode* prev;
+    BaseNode* next;
+  };
+
+  // Real nodes are never empty: the one that loses its last element is freed
+  struct Node : BaseNode {
+    Node() : BaseNode{nullptr, nullptr} {
+    }
+
+    T* Values() noexcept {
+      return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    size_t count = 0;
+    alignas(T) unsigned char storage[NodeCapacity * sizeof(T)];
+  };
+
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+public:
+  class ListIterator{
+    public:
+      using value_type = T;
+      using reference_type = value_type&;
+      using pointer_type = value_type*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::bidirectional_iterator_tag;
+      // Names std::iterator_traits looks for
+      using reference = reference_type;
+      using pointer = pointer_type;
+
+      ListIterator() = default;
+
+      inline bool operator==(const ListIterator& other) const {
+          return current == other.current && index == other.index;
+      };
+
+      inline bool operator!=(const ListIterator& other) const {
+          return !(*this == other);
+      };
+
+      inline reference_type operator*() const {
+          return static_cast<Node*>(current)->Values()[index];
+      };
+
+      ListIterator& operator++() {
+          if (++index == static_cast<Node*>(current)->count) {
+              current = current->next;
+              index = 0;
+          }
+          return *this;
+      };
+
+      ListIterator operator++(int) {
+          ListIterator old = *this;
+          ++*this;
+          return old;
+      };
+
+      // From End() this steps onto the last element, since the sentinel's prev is the last node
+      ListIterator& operator--() {
+          if (index == 0) {
+              current = current->prev;
+              index = static_cast<Node*>(current)->count;
+          }
+          --index;
+          return *this;
+      };
+
+      ListIterator operator--(int) {
+          ListIterator old = *this;
+          --*this;
+          return old;
+      };
+
+      inline pointer_type operator->() const {
+          return &**this;
+      };
+
+  private:
+      friend class UnrolledList;
+
+      ListIterator(const BaseNode* node, size_t pos) : current(const_cast<BaseNode*>(node)), index(pos) {
+      }
+
+  private:
+      BaseNode* current = nullptr;
+      size_t index = 0;
+  };
+
+public:
+  UnrolledList() : UnrolledList(Allocator()) {
+  }
+
+  explicit UnrolledList(const Allocator& alloc) : alloc_(alloc) {
+    Reset();
+  }
+
+  explicit UnrolledList(size_t sz, const Allocator& alloc = Allocator()) : UnrolledList(alloc) {
+    for (size_t i = 0; i < sz; ++i) {
+      AppendBack();
+    }
+  }
+
+  UnrolledList(const std::initializer_list<T>& values, const Allocator& alloc = Allocator())
+      : UnrolledList(alloc) {
+    for (const T& value : values) {
+      AppendBack(value);
+    }
+  }
+
+  UnrolledList(const UnrolledList& other)
+      : UnrolledList(other, NodeTraits::select_on_container_copy_construction(other.alloc_)) {
+  }
+
+  UnrolledList(const UnrolledList& other, const Allocator& alloc) : UnrolledList(alloc) {
+    AppendCopy(other);
+  }
+
+  UnrolledList& operator=(const UnrolledList& other) {
+    if (this != &other) {
+      Clear();
+      if constexpr (NodeTraits::propagate_on_container_copy_assignment::value) {
+        alloc_ = other.alloc_;
+      }
+      AppendCopy(other);
+    }
+    return *this;
+  }
+
+  UnrolledList(UnrolledList&& other) noexcept : alloc_(std::move(other.alloc_)) {
+    Reset();
+    StealNodes(other);
+  }
+
+  UnrolledList& operator=(UnrolledList&& other) noexcept(
+      NodeTraits::propagate_on_container_move_assignment::value || NodeTraits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    if constexpr (NodeTraits::propagate_on_container_move_assignment::value) {
+      alloc_ = std::move(other.alloc_);
+    } else if (!(alloc_ == other.alloc_)) {
+      // Our allocator cannot free the other nodes: move the elements instead
+      for (auto it = other.Begin(); it != other.End(); ++it) {
+        AppendBack(std::move(*it));
+      }
+      other.Clear();
+      return *this;
+    }
+    StealNodes(other);
+    return *this;
+  }
+
+  ListIterator Begin() const noexcept {
+    return ListIterator(head_.next, 0);
+  }
+
+  ListIterator End() const noexcept {
+    return ListIterator(&head_, 0);
+  }
+
+  inline T& Front() const {
+    return static_cast<Node*>(head_.next)->Values()[0];
+  }
+
+  inline T& Back() const {
+    Node* last = static_cast<Node*>(head_.prev);
+    return last->Values()[last->count - 1];
+  }
+
+  inline bool IsEmpty() const noexcept {
+    return size_ == 0;
+  }
+
+  inline size_t Size() const noexcept {
+    return size_;
+  }
+
+  Allocator GetAllocator() const {
+    return Allocator(alloc_);
+  }
+
+  void Swap(UnrolledList& other) {
+    if constexpr (NodeTraits::propagate_on_container_swap::value) {
+      std::swap(alloc_, other.alloc_);
+    }
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+    RelinkSentinel();
+    other.RelinkSentinel();
+  }
+
+  // Scans the arrays of the nodes in turn
+  ListIterator Find(const T& value) const {
+    for (BaseNode* base = head_.next; base != &head_; base = base->next) {
+      auto node = static_cast<Node*>(base);
+      T* values = node->Values();
+      for (size_t i = 0; i < node->count; ++i) {
+        if (values[i] == value) {
+          return ListIterator(node, i);
+        }
+      }
+    }
+    return End();
+  }
+
+  void Erase(ListIterator pos) {
+    auto node = static_cast<Node*>(pos.current);
+    T* values = node->Values();
+    std::move(values + pos.index + 1, values + node->count, values + pos.index);
+    NodeTraits::destroy(alloc_, values + node->count - 1);
+    --node->count;
+    --size_;
+    if (node->count == 0) {
+      Unlink(node);
+    } else if (node->count < NodeCapacity / 2 && node->next != &head_) {
+      auto next = static_cast<Node*>(node->next);
+      if (node->count + next->count <= NodeCapacity) {
+        MoveTail(next, 0, node);
+        Unlink(next);
+      }
+    }
+  }
+
+  void Insert(ListIterator pos, const T& value) {
+    EmplaceAt(pos, value);
+  }
+
+  void Insert(ListIterator pos, T&& value) {
+    EmplaceAt(pos, std::move(value));
+  }
+
+  // Constructs the element from args right before pos; when pos is in the
+  // middle of a node, the value is built first and moved into its slot
+  template <typename... Args>
+  ListIterator Emplace(ListIterator pos, Args&&... args) {
+    return EmplaceAt(pos, std::forward<Args>(args)...);
+  }
+
+  void Clear() noexcept {
+    BaseNode* base = head_.next;
+    while (base != &head_) {
+      BaseNode* next = base->next;
+      DestroyNode(static_cast<Node*>(base));
+      base = next;
+    }
+    Reset();
+  }
+
+  void PushBack(const T& value) {
+    AppendBack(value);
+  }
+
+  void PushBack(T&& value) {
+    AppendBack(std::move(value));
+  }
+
+  void PushFront(const T& value) {
+    EmplaceAt(Begin(), value);
+  }
+
+  void PushFront(T&& value) {
+    EmplaceAt(Begin(), std::move(value));
+  }
+
+  template <typename... Args>
+  T& EmplaceBack(Args&&... args) {
+    return *AppendBack(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  T& EmplaceFront(Args&&... args) {
+    return *EmplaceAt(Begin(), std::forward<Args>(args)...);
+  }
+
+  void PopBack() {
+    if (IsEmpty()) {
+      throw std::runtime_error("PopBack from an empty list");
+    }
+    Erase(ListIterator(head_.prev, static_cast<Node*>(head_.prev)->count - 1));
+  }
+
+  void PopFront() {
+    if (IsEmpty()) {
+      throw std::runtime_error("PopFront from an empty list");
+    }
+    Erase(Begin());
+  }
+
+  ~UnrolledList() {
+    Clear();
+  }
+
+private:
+  // Empty state: the sentinel points to itself
+  void Reset() noexcept {
+    head_.prev = &head_;
+    head_.next = &head_;
+    size_ = 0;
+  }
+
+  // Allocates an empty node and links it right before pos
+  Node* CreateNode(BaseNode* pos) {
+    Node* node = NodeTraits::allocate(alloc_, 1);
+    NodeTraits::construct(alloc_, node);
+    node->prev = pos->prev;
+    node->next = pos;
+    pos->prev->next = node;
+    pos->prev = node;
+    return node;
+  }
+
+  void DestroyNode(Node* node) noexcept {
+    T* values = node->Values();
+    for (size_t i = 0; i < node->count; ++i) {
+      NodeTraits::destroy(alloc_, values + i);
+    }
+    NodeTraits::destroy(alloc_, node);
+    NodeTraits::deallocate(alloc_, node, 1);
+  }
+
+  void Unlink(Node* node) noexcept {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    DestroyNode(node);
+  }
+
+  // Moves the elements of from starting at first to the end of to, which has
+  // room for them. If a constructor throws, both nodes are left as they were.
+  void MoveTail(Node* from, size_t first, Node* to) {
+    T* source = from->Values() + first;
+    T* target = to->Values() + to->count;
+    size_t count = from->count - first;
+    size_t moved = 0;
+    try {
+      for (; moved < count; ++moved) {
+        NodeTraits::construct(alloc_, target + moved, std::move_if_noexcept(source[moved]));
+      }
+    } catch (...) {
+      for (size_t i = 0; i < moved; ++i) {
+        NodeTraits::destroy(alloc_, target + i);
+      }
+      throw;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      NodeTraits::destroy(alloc_, source + i);
+    }
+    to->count += count;
+    from->count = first;
+  }
+
+  // Constructs the element in the free slot at the end of node
+  template <typename... Args>
+  ListIterator ConstructLast(Node* node, Args&&... args) {
+    NodeTraits::construct(alloc_, node->Values() + node->count, std::forward<Args>(args)...);
+    ++size_;
+    return ListIterator(node, node->count++);
+  }
+
+  template <typename... Args>
+  ListIterator AppendBack(Args&&... args) {
+    auto last = static_cast<Node*>(head_.prev);
+    if (last != &head_ && last->count < NodeCapacity) {
+      return ConstructLast(last, std::forward<Args>(args)...);
+    }
+    last = CreateNode(&head_);
+    try {
+      return ConstructLast(last, std::forward<Args>(args)...);
+    } catch (...) {
+      Unlink(last);
+      throw;
+    }
+  }
+
+  // Constructs an element from args right before pos
+  template <typename... Args>
+  ListIterator EmplaceAt(ListIterator pos, Args&&... args) {
+    BaseNode* base = pos.current;
+    size_t index = pos.index;
+    if (index == 0 && base->prev != &head_ &&
+        static_cast<Node*>(base->prev)->count < NodeCapacity) {
+      // Before the first element of a node: the end of the previous node is the same place
+      return ConstructLast(static_cast<Node*>(base->prev), std::forward<Args>(args)...);
+    }
+    if (base == &head_) {
+      return AppendBack(std::forward<Args>(args)...);
+    }
+    auto node = static_cast<Node*>(base);
+    // Build the element first, so a throwing constructor leaves the list intact
+    T value(std::forward<Args>(args)...);
+    if (node->count == NodeCapacity) {
+      Node* upper = CreateNode(node->next);
+      try {
+        MoveTail(node, NodeCapacity / 2, upper);
+      } catch (...) {
+        Unlink(upper);
+        throw;
+      }
+      // pos was an element of the full node, so it stays an element of whichever half holds it
+      if (index >= NodeCapacity / 2) {
+        node = upper;
+        index -= NodeCapacity / 2;
+      }
+    }
+    T* values = node->Values();
+    NodeTraits::construct(alloc_, values + node->count, std::move(values[node->count - 1]));
+    ++node->count;
+    std::move_backward(values + index, values + node->count - 2, values + node->count - 1);
+    values[index] = std::move(value);
+    ++size_;
+    return ListIterator(node, index);
+  }
+
+  void AppendCopy(const UnrolledList& other) {
+    for (auto it = other.Begin(); it != other.End(); ++it) {
+      AppendBack(*it);
+    }
+  }
+
+  // Points the first and the last node back to our sentinel after head_ was copied from another list
+  void RelinkSentinel() noexcept {
+    if (size_ == 0) {
+      Reset();
+      return;
+    }
+    head_.next->prev = &head_;
+    head_.prev->next = &head_;
+  }
+
+  // Takes all the nodes of other, which must be allocated compatibly; this list must be empty
+  void StealNodes(UnrolledList& other) noexcept {
+    head_ = other.head_;
+    size_ = other.size_;
+    RelinkSentinel();
+    other.Reset();
+  }
+
+private:
+  BaseNode head_;
+  size_t size_;
+  [[no_unique_address]] NodeAllocator alloc_;
+};
+
+
+namespace std {
+  // Global swap overloading
+  template <typename T, size_t NodeCapacity, typename Allocator>
+  void swap(UnrolledList<T, NodeCapacity, Allocator>& a, UnrolledList<T, NodeCapacity, Allocator>& b) {
+    a.Swap(b);
+  }
+}
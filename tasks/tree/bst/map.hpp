@@ -2,88 +2,289 @@
 
 #include <cstdlib>
 #include <functional>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
 #include <vector>
 #include <utility>
 
 #include <fmt/core.h>
 
+// Unbalanced binary search tree. Nodes come from Allocator rebound to the node
+// type, so any std::allocator-compatible allocator (an arena, a node pool) can
+// supply them.
 template <
   typename Key,
   typename Value,
-  typename Compare = std::less<Key>
+  typename Compare = std::less<Key>,
+  typename Allocator = std::allocator<std::pair<const Key, Value>>
 >
 class Map {
+private:
+  class Node;
+
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
 public:
-  Map() {
-    // Not implemented
+  Map() : Map(Allocator()) {
+  }
+
+  explicit Map(const Allocator& alloc) : root_(nullptr), size_(0), alloc_(alloc) {
+  }
+
+  Map(const Map& other)
+      : Map(other, NodeTraits::select_on_container_copy_construction(other.alloc_)) {
+  }
+
+  Map(const Map& other, const Allocator& alloc) : comp(other.comp), root_(nullptr), size_(0), alloc_(alloc) {
+    CopyTree(other);
+  }
+
+  Map& operator=(const Map& other) {
+    if (this != &other) {
+      Clear();
+      comp = other.comp;
+      if constexpr (NodeTraits::propagate_on_container_copy_assignment::value) {
+        alloc_ = other.alloc_;
+      }
+      CopyTree(other);
+    }
+    return *this;
+  }
+
+  Map(Map&& other) noexcept
+      : comp(std::move(other.comp)),
+        root_(std::exchange(other.root_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        alloc_(std::move(other.alloc_)) {
   }
 
-  Value& operator[](const Key& /*key*/) {
-    std::abort(); // Not implemented
+  Map& operator=(Map&& other) noexcept(NodeTraits::propagate_on_container_move_assignment::value ||
+                                       NodeTraits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    comp = std::move(other.comp);
+    if constexpr (NodeTraits::propagate_on_container_move_assignment::value) {
+      alloc_ = std::move(other.alloc_);
+    } else if (!(alloc_ == other.alloc_)) {
+      // Our allocator cannot free the other nodes: copy them and drop the originals
+      CopyTree(other);
+      other.Clear();
+      return *this;
+    }
+    root_ = std::exchange(other.root_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+
+  Value& operator[](const Key& key) {
+    Node** slot = FindSlot(key);
+    if (*slot == nullptr) {
+      *slot = CreateNode(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
+    }
+    return (*slot)->value.second;
   }
 
   inline bool IsEmpty() const noexcept {
-    std::abort(); // Not implemented
+    return size_ == 0;
   }
 
   inline size_t Size() const noexcept {
-    std::abort(); // Not implemented
+    return size_;
   }
 
   void Swap(Map& a) {
     static_assert(std::is_same<decltype(this->comp), decltype(a.comp)>::value,
                   "The compare function types are different");
-    // Not implemented
+    std::swap(comp, a.comp);
+    if constexpr (NodeTraits::propagate_on_container_swap::value) {
+      std::swap(alloc_, a.alloc_);
+    }
+    std::swap(root_, a.root_);
+    std::swap(size_, a.size_);
   }
 
-  std::vector<std::pair<const Key, Value>> Values(bool /*is_increase=true*/) const noexcept {
-    std::abort(); // Not implemented
+  std::vector<std::pair<const Key, Value>> Values(bool is_increase) const noexcept {
+    std::vector<std::pair<const Key, Value>> values;
+    values.reserve(size_);
+    // In-order walk with an explicit stack: a degenerate tree is as deep as it is large
+    std::vector<const Node*> path;
+    const Node* node = root_;
+    while (node != nullptr || !path.empty()) {
+      while (node != nullptr) {
+        path.push_back(node);
+        node = is_increase ? node->left : node->right;
+      }
+      node = path.back();
+      path.pop_back();
+      values.push_back(node->value);
+      node = is_increase ? node->right : node->left;
+    }
+    return values;
   }
 
-  void Insert(const std::pair<const Key, Value>& /*val*/) {
-    // Not implemented
+  void Insert(const std::pair<const Key, Value>& val) {
+    Node** slot = FindSlot(val.first);
+    if (*slot == nullptr) {
+      *slot = CreateNode(val);
+    } else {
+      (*slot)->value.second = val.second;
+    }
   }
 
-  void Insert(const std::initializer_list<std::pair<const Key, Value>>& /*values*/){
-    // Not implemented
+  void Insert(const std::initializer_list<std::pair<const Key, Value>>& values){
+    for (const auto& val : values) {
+      Insert(val);
+    }
   }
 
-  void Erase(const Key& /*key*/) {
-    // Not implemented
+  void Erase(const Key& key) {
+    Node** slot = FindSlot(key);
+    Node* node = *slot;
+    if (node == nullptr) {
+      throw std::runtime_error("Value not found");
+    }
+    if (node->left == nullptr) {
+      *slot = node->right;
+    } else if (node->right == nullptr) {
+      *slot = node->left;
+    } else {
+      // Keys are const, so the minimum of the right subtree is relinked in place of node
+      Node** min_slot = &node->right;
+      while ((*min_slot)->left != nullptr) {
+        min_slot = &(*min_slot)->left;
+      }
+      Node* min = *min_slot;
+      *min_slot = min->right;
+      min->left = node->left;
+      min->right = node->right;
+      *slot = min;
+    }
+    DestroyNode(node);
   }
 
   void Clear() noexcept {
-    // Not implemented
+    // Rotate left children up until the current node has none, then free it
+    // and go right: no recursion and no extra memory
+    Node* node = root_;
+    while (node != nullptr) {
+      if (node->left != nullptr) {
+        Node* left = node->left;
+        node->left = left->right;
+        left->right = node;
+        node = left;
+      } else {
+        Node* right = node->right;
+        DestroyNode(node);
+        node = right;
+      }
+    }
+    root_ = nullptr;
+  }
+
+  bool Find(const Key& key) const {
+    return *FindSlot(key) != nullptr;
   }
 
-  bool Find(const Key& /*key*/) const {
-    std::abort(); // Not implemented
+  Allocator GetAllocator() const {
+    return Allocator(alloc_);
   }
 
   ~Map() {
-    // Not implemented
+    Clear();
   }
 
 private:
   class Node {
     friend class Map;
 
+    public:
+      template <typename... Args>
+      explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {
+      }
 
     private:
-      /*???*/
+      std::pair<const Key, Value> value;
+      Node* left = nullptr;
+      Node* right = nullptr;
   };
-  /*???*/
+
+  // Returns the link that points to the node with key, or the null link where
+  // such a node would be attached. Every operation starts here.
+  Node** FindSlot(const Key& key) const {
+    // The links are only written through by non-const callers
+    Node** slot = const_cast<Node**>(&root_);
+    while (*slot != nullptr) {
+      if (comp(key, (*slot)->value.first)) {
+        slot = &(*slot)->left;
+      } else if (comp((*slot)->value.first, key)) {
+        slot = &(*slot)->right;
+      } else {
+        break;
+      }
+    }
+    return slot;
+  }
+
+  template <typename... Args>
+  Node* CreateNode(Args&&... args) {
+    Node* node = NodeTraits::allocate(alloc_, 1);
+    try {
+      NodeTraits::construct(alloc_, node, std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(alloc_, node, 1);
+      throw;
+    }
+    ++size_;
+    return node;
+  }
+
+  void DestroyNode(Node* node) noexcept {
+    NodeTraits::destroy(alloc_, node);
+    NodeTraits::deallocate(alloc_, node, 1);
+    --size_;
+  }
+
+  // Copies the shape of other into this empty map; on exception the part
+  // copied so far is a valid tree and is freed
+  void CopyTree(const Map& other) {
+    std::vector<std::pair<const Node*, Node**>> pending;
+    if (other.root_ != nullptr) {
+      pending.emplace_back(other.root_, &root_);
+    }
+    try {
+      while (!pending.empty()) {
+        auto [from, slot] = pending.back();
+        pending.pop_back();
+        Node* node = CreateNode(from->value);
+        *slot = node;
+        if (from->left != nullptr) {
+          pending.emplace_back(from->left, &node->left);
+        }
+        if (from->right != nullptr) {
+          pending.emplace_back(from->right, &node->right);
+        }
+      }
+    } catch (...) {
+      Clear();
+      throw;
+    }
+  }
 
 private:
   Compare comp;
-  /*???*/
-
+  Node* root_;
+  size_t size_;
+  [[no_unique_address]] NodeAllocator alloc_;
 };
 
 namespace std{
 // Global swap overloading
-  template <typename Key, typename Value>
-  void swap(Map<Key, Value>& a, Map<Key, Value>& b) {
+  template <typename Key, typename Value, typename Compare, typename Allocator>
+  void swap(Map<Key, Value, Compare, Allocator>& a, Map<Key, Value, Compare, Allocator>& b) {
     a.Swap(b);
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Monotonic arena: hands out memory by bumping a pointer through large chunks
+// and never frees single allocations. Reset() rewinds to the first chunk in
+// O(1) and keeps every chunk, so a request handler that resets the arena
+// between requests stops calling malloc once the chunks cover its peak.
+//
+// Reset() does not run destructors: containers that use the arena must be
+// destroyed (or hold trivially destructible values and be abandoned) before it.
+// One arena must not be used by several threads at once.
+class MonotonicArena {
+public:
+    static constexpr size_t DefaultChunkSize = size_t{64} << 10;
+    static constexpr size_t MaxChunkSize = size_t{16} << 20;
+
+    explicit MonotonicArena(size_t first_chunk_size = DefaultChunkSize) noexcept
+        : next_chunk_size_(std::max(first_chunk_size, sizeof(Chunk))) {
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        auto cursor = reinterpret_cast<uintptr_t>(cursor_);
+        uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t{alignment} - 1);
+        if (cursor_ == nullptr || aligned - cursor > static_cast<size_t>(end_ - cursor_) ||
+            bytes > static_cast<size_t>(end_ - cursor_) - (aligned - cursor)) {
+            return AllocateFromNextChunk(bytes, alignment);
+        }
+        cursor_ = reinterpret_cast<char*>(aligned + bytes);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Memory is only given back by Reset() and the destructor
+    void Deallocate(void*, size_t) noexcept {
+    }
+
+    void Reset() noexcept {
+        current_ = first_;
+        if (current_ != nullptr) {
+            cursor_ = current_->Begin();
+            end_ = current_->End();
+        }
+    }
+
+    // Total size of the chunks the arena owns
+    size_t ReservedBytes() const noexcept {
+        size_t bytes = 0;
+        for (Chunk* chunk = first_; chunk != nullptr; chunk = chunk->next) {
+            bytes += chunk->size;
+        }
+        return bytes;
+    }
+
+    ~MonotonicArena() {
+        while (first_ != nullptr) {
+            Chunk* next = first_->next;
+            ::operator delete(first_);
+            first_ = next;
+        }
+    }
+
+private:
+    // Header at the start of each chunk; the allocations follow it
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        size_t size;
+
+        char* Begin() noexcept {
+            return reinterpret_cast<char*>(this + 1);
+        }
+
+        char* End() noexcept {
+            return reinterpret_cast<char*>(this) + size;
+        }
+    };
+
+    // Moves to the chunk after the current one, reusing it if it is large
+    // enough and linking a new chunk in front of it otherwise
+    void* AllocateFromNextChunk(size_t bytes, size_t alignment) {
+        if (bytes > std::numeric_limits<size_t>::max() - sizeof(Chunk) - alignment) {
+            throw std::bad_alloc();
+        }
+        size_t needed = sizeof(Chunk) + bytes + alignment - 1;
+        Chunk* next = current_ != nullptr ? current_->next : first_;
+        if (next == nullptr || next->size < needed) {
+            size_t size = std::max(needed, next_chunk_size_);
+            next_chunk_size_ = std::min(next_chunk_size_ * 2, std::max(MaxChunkSize, next_chunk_size_));
+            auto chunk = static_cast<Chunk*>(::operator new(size));
+            chunk->next = next;
+            chunk->size = size;
+            if (current_ != nullptr) {
+                current_->next = chunk;
+            } else {
+                first_ = chunk;
+            }
+            next = chunk;
+        }
+        current_ = next;
+        cursor_ = current_->Begin();
+        end_ = current_->End();
+        return Allocate(bytes, alignment);
+    }
+
+    Chunk* first_ = nullptr;
+    Chunk* current_ = nullptr;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    size_t next_chunk_size_;
+};
+
+// std::allocator-compatible handle to a MonotonicArena, so Vector, List,
+// ForwardList and Map can take their buffers and nodes from it:
+//
+//     MonotonicArena arena;
+//     List<int, ArenaAllocator<int>> list{ArenaAllocator<int>(arena)};
+//
+// deallocate() is a no-op: memory comes back on arena.Reset(). Containers
+// carry their arena along on copy assignment, move and swap.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept : arena_(&arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.Arena()) {
+    }
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        arena_->Deallocate(ptr, count * sizeof(T));
+    }
+
+    MonotonicArena* Arena() const noexcept {
+        return arena_;
+    }
+
+    friend bool operator==(const ArenaAllocator& a, const ArenaAllocator& b) noexcept {
+        return a.arena_ == b.arena_;
+    }
+
+private:
+    MonotonicArena* arena_;
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Pool of equally sized blocks. Freed blocks go to an intrusive free list
+// (the link is stored in the block itself) and are handed out again first;
+// when the list is empty the pool bumps through its current slab, and a full
+// slab is followed by one twice as large, up to MaxSlabSize. Memory goes back
+// to the system only when the pool is destroyed.
+//
+// One pool must not be used by several threads at once; see PoolAllocator
+// for the thread-safe, optionally thread-cached wrapper.
+class NodePool {
+public:
+    static constexpr size_t FirstSlabBlocks = 64;
+    static constexpr size_t MaxSlabSize = size_t{1} << 20;
+
+    NodePool(size_t block_size, size_t block_alignment) noexcept
+        : block_alignment_(std::max(block_alignment, alignof(FreeBlock))),
+          block_size_(RoundUp(std::max(block_size, sizeof(FreeBlock)), block_alignment_)),
+          slab_alignment_(std::max(block_alignment_, alignof(Slab))),
+          next_slab_blocks_(FirstSlabBlocks) {
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    void* Allocate() {
+        if (free_ != nullptr) {
+            return std::exchange(free_, free_->next);
+        }
+        if (cursor_ == end_) {
+            AddSlab();
+        }
+        return std::exchange(cursor_, cursor_ + block_size_);
+    }
+
+    void Deallocate(void* ptr) noexcept {
+        free_ = ::new (ptr) FreeBlock{free_};
+    }
+
+    size_t BlockSize() const noexcept {
+        return block_size_;
+    }
+
+    // Total size of the slabs the pool owns
+    size_t ReservedBytes() const noexcept {
+        size_t bytes = 0;
+        for (Slab* slab = slabs_; slab != nullptr; slab = slab->next) {
+            bytes += slab->size;
+        }
+        return bytes;
+    }
+
+    ~NodePool() {
+        while (slabs_ != nullptr) {
+            Slab* next = slabs_->next;
+            ::operator delete(slabs_, std::align_val_t{slab_alignment_});
+            slabs_ = next;
+        }
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Header at the start of each slab; the blocks follow it
+    struct alignas(std::max_align_t) Slab {
+        Slab* next;
+        size_t size;
+    };
+
+    static size_t RoundUp(size_t size, size_t alignment) noexcept {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    void AddSlab() {
+        size_t header = RoundUp(sizeof(Slab), block_alignment_);
+        size_t size = header + next_slab_blocks_ * block_size_;
+        if (size < MaxSlabSize) {
+            next_slab_blocks_ *= 2;
+        }
+        auto slab = ::new (::operator new(size, std::align_val_t{slab_alignment_})) Slab{slabs_, size};
+        slabs_ = slab;
+        cursor_ = reinterpret_cast<char*>(slab) + header;
+        end_ = reinterpret_cast<char*>(slab) + size;
+    }
+
+    size_t block_alignment_;
+    size_t block_size_;
+    size_t slab_alignment_;
+    size_t next_slab_blocks_;
+    Slab* slabs_ = nullptr;
+    FreeBlock* free_ = nullptr;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+};
+
+enum class PoolCache {
+    // Every allocation locks the process-wide pool
+    Shared,
+    // Each thread keeps a small free list and trades batches with the shared pool
+    PerThread,
+};
+
+namespace detail {
+
+// Process-wide pool for one block size. It is created on first use and never
+// destroyed, so containers in static storage can still free their nodes at exit.
+template <size_t Size, size_t Alignment>
+class SharedNodePool {
+public:
+    static SharedNodePool& Instance() {
+        static SharedNodePool* pool = new SharedNodePool();
+        return *pool;
+    }
+
+    void* Allocate() {
+        std::lock_guard lock(mutex_);
+        return pool_.Allocate();
+    }
+
+    void Deallocate(void* ptr) noexcept {
+        std::lock_guard lock(mutex_);
+        pool_.Deallocate(ptr);
+    }
+
+    // Both batch calls take the lock once for count blocks
+    template <typename Sink>
+    void AllocateBatch(size_t count, Sink&& sink) {
+        std::lock_guard lock(mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            sink(pool_.Allocate());
+        }
+    }
+
+    template <typename Source>
+    void DeallocateBatch(size_t count, Source&& source) noexcept {
+        std::lock_guard lock(mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            pool_.Deallocate(source());
+        }
+    }
+
+    size_t ReservedBytes() {
+        std::lock_guard lock(mutex_);
+        return pool_.ReservedBytes();
+    }
+
+private:
+    SharedNodePool() : pool_(Size, Alignment) {
+    }
+
+    std::mutex mutex_;
+    NodePool pool_;
+};
+
+// Free list of one thread in front of SharedNodePool<Size, Alignment>. Blocks
+// freed by this thread land here whichever thread allocated them; the cache
+// refills and drains in batches and gives everything back when the thread
+// exits. Blocks freed after that (by thread_local or static containers
+// destroyed later) go straight to the shared pool.
+template <size_t Size, size_t Alignment>
+class ThreadNodeCache {
+public:
+    static constexpr size_t BatchSize = 256;
+
+    static void* Allocate() {
+        State& state = Current();
+        if (state.exited) {
+            return SharedNodePool<Size, Alignment>::Instance().Allocate();
+        }
+        if (state.free == nullptr) {
+            SharedNodePool<Size, Alignment>::Instance().AllocateBatch(BatchSize, [&state](void* ptr) {
+                Push(state, ptr);
+            });
+        }
+        --state.count;
+        return std::exchange(state.free, state.free->next);
+    }
+
+    static void Deallocate(void* ptr) noexcept {
+        State& state = Current();
+        if (state.exited) {
+            SharedNodePool<Size, Alignment>::Instance().Deallocate(ptr);
+            return;
+        }
+        Push(state, ptr);
+        if (state.count > 2 * BatchSize) {
+            Drain(state, BatchSize);
+        }
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Trivially destructible, so it stays usable after ExitGuard has run
+    struct State {
+        FreeBlock* free;
+        size_t count;
+        bool registered;
+        bool exited;
+    };
+
+    struct ExitGuard {
+        ~ExitGuard() {
+            Drain(current_, current_.count);
+            current_.exited = true;
+        }
+    };
+
+    static State& Current() {
+        if (!current_.registered) {
+            current_.registered = true;
+            static thread_local ExitGuard guard;
+        }
+        return current_;
+    }
+
+    static void Push(State& state, void* ptr) noexcept {
+        state.free = ::new (ptr) FreeBlock{state.free};
+        ++state.count;
+    }
+
+    static void Drain(State& state, size_t count) noexcept {
+        state.count -= count;
+        SharedNodePool<Size, Alignment>::Instance().DeallocateBatch(count, [&state] {
+            return std::exchange(state.free, state.free->next);
+        });
+    }
+
+    static inline thread_local State current_{};
+};
+
+}  // namespace detail
+
+// Stateless std::allocator-compatible allocator that serves single objects
+// from a process-wide NodePool for sizeof(T). Node containers allocate one
+// node at a time and rebind the allocator to their node type, so
+//
+//     List<int, PoolAllocator<int>> list;
+//     Map<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> map;
+//
+// get a pool sized exactly for their nodes. Requests for several objects
+// (a Vector buffer) go to operator new. Any thread may free any block.
+template <typename T, PoolCache Cache = PoolCache::PerThread>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = PoolAllocator<U, Cache>;
+    };
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Cache>&) noexcept {
+    }
+
+    T* allocate(size_t count) {
+        if (count != 1) {
+            if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+        if constexpr (Cache == PoolCache::PerThread) {
+            return static_cast<T*>(detail::ThreadNodeCache<sizeof(T), alignof(T)>::Allocate());
+        } else {
+            return static_cast<T*>(detail::SharedNodePool<sizeof(T), alignof(T)>::Instance().Allocate());
+        }
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (count != 1) {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        } else if constexpr (Cache == PoolCache::PerThread) {
+            detail::ThreadNodeCache<sizeof(T), alignof(T)>::Deallocate(ptr);
+        } else {
+            detail::SharedNodePool<sizeof(T), alignof(T)>::Instance().Deallocate(ptr);
+        }
+    }
+
+    // Slab memory of the pool that serves T, shared by every PoolAllocator of that size
+    static size_t ReservedBytes() {
+        return detail::SharedNodePool<sizeof(T), alignof(T)>::Instance().ReservedBytes();
+    }
+
+    friend bool operator==(const PoolAllocator&, const PoolAllocator&) noexcept {
+        return true;
+    }
+};
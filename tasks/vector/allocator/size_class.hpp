@@ -0,0 +1,393 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Thread-caching allocator for small objects, in the spirit of tcmalloc and
+// mimalloc:
+//
+//  * Requests up to MaxSmallSize bytes are rounded up to one of the size
+//    classes. Blocks of a class are carved out of 64 KB spans; the span header
+//    records the class and the thread heap that owns the span.
+//  * Every thread has a heap with a free list per class. Allocation and a free
+//    by the owning thread are a pop and a push on that list, with no locks.
+//  * A block freed by another thread goes onto the owner's remote-free queue,
+//    a lock-free stack. The owner takes the whole queue with one exchange when
+//    its local list runs dry, so producer/consumer pipelines recycle blocks
+//    without a lock.
+//  * A local list longer than two batches gives one batch back to the central
+//    free list of its class; an empty local list first refills from there.
+//  * When a thread exits its heap returns all cached blocks to the central
+//    lists and is parked for the next new thread to adopt, together with its
+//    spans and remote-free queue.
+//
+// Spans are never returned to the system.
+namespace detail {
+
+inline constexpr size_t SpanSize = size_t{64} << 10;
+inline constexpr size_t MaxSmallSize = 1024;
+inline constexpr size_t SmallAlignment = 16;
+
+// 16-byte steps up to 128, then four classes per power of two up to 1024
+inline constexpr std::array<uint32_t, 20> SizeClasses = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024,
+};
+
+inline constexpr size_t NumSizeClasses = SizeClasses.size();
+
+// Class index for every size rounded up to SmallAlignment
+inline constexpr auto SizeClassTable = [] {
+    std::array<uint8_t, MaxSmallSize / SmallAlignment + 1> table{};
+    size_t size_class = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        while (SizeClasses[size_class] < i * SmallAlignment) {
+            ++size_class;
+        }
+        table[i] = static_cast<uint8_t>(size_class);
+    }
+    return table;
+}();
+
+inline size_t SizeClassOf(size_t bytes) noexcept {
+    return SizeClassTable[(bytes + SmallAlignment - 1) / SmallAlignment];
+}
+
+// Blocks moved between a thread heap and the central list at once: 16 KB, 8..256 blocks
+inline constexpr auto BatchBlocks = [] {
+    std::array<uint32_t, NumSizeClasses> batches{};
+    for (size_t i = 0; i < NumSizeClasses; ++i) {
+        uint32_t blocks = (uint32_t{16} << 10) / SizeClasses[i];
+        batches[i] = blocks < 8 ? 8 : (blocks > 256 ? 256 : blocks);
+    }
+    return batches;
+}();
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+class ThreadHeap;
+
+struct alignas(64) SpanHeader {
+    ThreadHeap* owner;
+    size_t size_class;
+    // Spans of one heap are linked, so they stay reachable for leak checkers
+    SpanHeader* next;
+};
+
+inline SpanHeader* SpanOf(void* ptr) noexcept {
+    return reinterpret_cast<SpanHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t{SpanSize} - 1));
+}
+
+// Singly linked list of free blocks with its length
+struct FreeList {
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+
+    void Push(void* ptr) noexcept {
+        head = ::new (ptr) FreeBlock{head};
+        ++count;
+    }
+
+    void* Pop() noexcept {
+        --count;
+        return std::exchange(head, head->next);
+    }
+};
+
+// Per-class lists shared by all threads
+class CentralFreeLists {
+public:
+    static CentralFreeLists& Instance() {
+        static CentralFreeLists* lists = new CentralFreeLists();
+        return *lists;
+    }
+
+    // Moves up to count blocks into list; returns how many were moved
+    size_t Take(size_t size_class, FreeList& list, size_t count) {
+        Central& central = centrals_[size_class];
+        std::lock_guard lock(central.mutex);
+        size_t taken = 0;
+        for (; taken < count && central.list.head != nullptr; ++taken) {
+            list.Push(central.list.Pop());
+        }
+        return taken;
+    }
+
+    // Moves count blocks from the front of list here under one lock
+    void Give(size_t size_class, FreeList& list, size_t count) noexcept {
+        Central& central = centrals_[size_class];
+        std::lock_guard lock(central.mutex);
+        for (size_t i = 0; i < count; ++i) {
+            central.list.Push(list.Pop());
+        }
+    }
+
+    void GiveOne(void* ptr) noexcept {
+        Central& central = centrals_[SpanOf(ptr)->size_class];
+        std::lock_guard lock(central.mutex);
+        central.list.Push(ptr);
+    }
+
+private:
+    struct alignas(64) Central {
+        std::mutex mutex;
+        FreeList list;
+    };
+
+    std::array<Central, NumSizeClasses> centrals_;
+};
+
+class ThreadHeap {
+    friend class HeapRegistry;
+
+public:
+    void* Allocate(size_t size_class) {
+        FreeList& list = lists_[size_class];
+        if (list.head != nullptr) {
+            return list.Pop();
+        }
+        return AllocateSlow(size_class);
+    }
+
+    void Deallocate(void* ptr, size_t size_class) noexcept {
+        FreeList& list = lists_[size_class];
+        list.Push(ptr);
+        size_t batch = BatchBlocks[size_class];
+        if (list.count > 2 * batch) {
+            CentralFreeLists::Instance().Give(size_class, list, batch);
+        }
+    }
+
+    // Called by any thread other than the owner
+    void PushRemote(void* ptr) noexcept {
+        auto block = ::new (ptr) FreeBlock{remote_.load(std::memory_order_relaxed)};
+        // seq_cst pairs the push with the abandoned_ load below and in Abandon()
+        while (!remote_.compare_exchange_weak(block->next, block, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+        }
+        if (abandoned_.load(std::memory_order_seq_cst)) {
+            // The heap may have drained its queue before our push: nobody else will
+            DrainRemoteToCentral();
+        }
+    }
+
+    bool IsAbandoned() const noexcept {
+        return abandoned_.load(std::memory_order_acquire);
+    }
+
+    // Gives every cached block to the central lists; the heap can be adopted afterwards
+    void Abandon() noexcept {
+        CentralFreeLists& central = CentralFreeLists::Instance();
+        for (size_t size_class = 0; size_class < NumSizeClasses; ++size_class) {
+            central.Give(size_class, lists_[size_class], lists_[size_class].count);
+        }
+        abandoned_.store(true, std::memory_order_seq_cst);
+        DrainRemoteToCentral();
+    }
+
+    void Adopt() noexcept {
+        abandoned_.store(false, std::memory_order_seq_cst);
+    }
+
+private:
+    void* AllocateSlow(size_t size_class) {
+        // Blocks other threads have freed come first: they are ours and need no lock
+        FreeBlock* remote = remote_.exchange(nullptr, std::memory_order_acquire);
+        while (remote != nullptr) {
+            FreeBlock* next = remote->next;
+            lists_[SpanOf(remote)->size_class].Push(remote);
+            remote = next;
+        }
+        FreeList& list = lists_[size_class];
+        if (list.head != nullptr ||
+            CentralFreeLists::Instance().Take(size_class, list, BatchBlocks[size_class]) > 0) {
+            return list.Pop();
+        }
+        // Nothing to reuse: bump through the span of the class, untouched blocks stay untouched
+        Span& span = spans_[size_class];
+        if (span.cursor == span.end) {
+            NewSpan(size_class);
+        }
+        return std::exchange(span.cursor, span.cursor + SizeClasses[size_class]);
+    }
+
+    void NewSpan(size_t size_class) {
+        auto header = ::new (::operator new(SpanSize, std::align_val_t{SpanSize})) SpanHeader{this, size_class, spans_head_};
+        spans_head_ = header;
+        size_t size = SizeClasses[size_class];
+        Span& span = spans_[size_class];
+        span.cursor = reinterpret_cast<char*>(header + 1);
+        span.end = span.cursor + (SpanSize - sizeof(SpanHeader)) / size * size;
+    }
+
+    void DrainRemoteToCentral() noexcept {
+        FreeBlock* remote = remote_.exchange(nullptr, std::memory_order_acquire);
+        while (remote != nullptr) {
+            FreeBlock* next = remote->next;
+            CentralFreeLists::Instance().GiveOne(remote);
+            remote = next;
+        }
+    }
+
+    // Part of the newest span of each class that was never handed out
+    struct Span {
+        char* cursor = nullptr;
+        char* end = nullptr;
+    };
+
+    std::array<FreeList, NumSizeClasses> lists_;
+    std::array<Span, NumSizeClasses> spans_;
+    SpanHeader* spans_head_ = nullptr;
+    // Link in the list of parked heaps, guarded by the HeapRegistry mutex
+    ThreadHeap* next_parked_ = nullptr;
+    alignas(64) std::atomic<FreeBlock*> remote_{nullptr};
+    std::atomic<bool> abandoned_{false};
+};
+
+// Heaps of exited threads, waiting to be adopted. Heaps are never destroyed:
+// their spans may still hold live blocks that point back at them.
+class HeapRegistry {
+public:
+    static ThreadHeap* Acquire() {
+        Parked& parked = Instance();
+        {
+            std::lock_guard lock(parked.mutex);
+            if (parked.head != nullptr) {
+                ThreadHeap* heap = std::exchange(parked.head, parked.head->next_parked_);
+                heap->Adopt();
+                return heap;
+            }
+        }
+        return new ThreadHeap();
+    }
+
+    static void Release(ThreadHeap* heap) noexcept {
+        heap->Abandon();
+        Parked& parked = Instance();
+        std::lock_guard lock(parked.mutex);
+        heap->next_parked_ = std::exchange(parked.head, heap);
+    }
+
+private:
+    struct Parked {
+        std::mutex mutex;
+        ThreadHeap* head = nullptr;
+    };
+
+    static Parked& Instance() {
+        static Parked* parked = new Parked();
+        return *parked;
+    }
+};
+
+// The calling thread's heap; nullptr once the thread has started exiting
+class CurrentHeap {
+public:
+    static ThreadHeap* Get() {
+        if (state.heap == nullptr && !state.exited) {
+            state.heap = HeapRegistry::Acquire();
+            static thread_local ExitGuard guard;
+        }
+        return state.heap;
+    }
+
+private:
+    // Trivially destructible, so it stays usable after ExitGuard has run
+    struct State {
+        ThreadHeap* heap;
+        bool exited;
+    };
+
+    struct ExitGuard {
+        ~ExitGuard() {
+            ThreadHeap* heap = std::exchange(state.heap, nullptr);
+            state.exited = true;
+            HeapRegistry::Release(heap);
+        }
+    };
+
+    static inline thread_local State state{};
+};
+
+inline void* AllocateSmall(size_t bytes) {
+    size_t size_class = SizeClassOf(bytes);
+    if (ThreadHeap* heap = CurrentHeap::Get()) {
+        return heap->Allocate(size_class);
+    }
+    // Thread is exiting: borrow a parked heap for this one block
+    ThreadHeap* heap = HeapRegistry::Acquire();
+    void* ptr = heap->Allocate(size_class);
+    HeapRegistry::Release(heap);
+    return ptr;
+}
+
+inline void DeallocateSmall(void* ptr) noexcept {
+    SpanHeader* span = SpanOf(ptr);
+    ThreadHeap* heap = CurrentHeap::Get();
+    if (span->owner == heap && heap != nullptr) {
+        heap->Deallocate(ptr, span->size_class);
+    } else if (heap != nullptr && !span->owner->IsAbandoned()) {
+        span->owner->PushRemote(ptr);
+    } else {
+        CentralFreeLists::Instance().GiveOne(ptr);
+    }
+}
+
+}  // namespace detail
+
+// Stateless std::allocator-compatible allocator over the thread-caching heaps.
+// Any thread may free what another thread allocated. Objects larger than
+// 1 KB or aligned to more than 16 bytes go to operator new.
+template <typename T>
+class SizeClassAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = SizeClassAllocator<U>;
+    };
+
+    SizeClassAllocator() noexcept = default;
+
+    template <typename U>
+    SizeClassAllocator(const SizeClassAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if (IsSmall(count)) {
+            return static_cast<T*>(detail::AllocateSmall(count * sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (IsSmall(count)) {
+            detail::DeallocateSmall(ptr);
+        } else {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        }
+    }
+
+    friend bool operator==(const SizeClassAllocator&, const SizeClassAllocator&) noexcept {
+        return true;
+    }
+
+private:
+    static bool IsSmall(size_t count) noexcept {
+        return alignof(T) <= detail::SmallAlignment && count * sizeof(T) <= detail::MaxSmallSize;
+    }
+};
@@ -0,0 +1,349 @@
+#include "../arena.hpp"
+#include "../pool.hpp"
+#include "../../vector/vector.hpp"
+#include "../../vector/vector.cpp"
+#include "../../../lists/list/list.hpp"
+#include "../../../lists/forward/forward_list.hpp"
+#include "../../../tree/bst/map.hpp"
+#include "../../vector/tests/allocation_counter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/core.h>
+#include <mimalloc.h>
+
+// Every container runs the same four workloads against every kind of memory.
+// A cell reports
+//   time/op - time per element inserted, erased, cleared or visited,
+//   allocs/op - calls into the backing heap (operator new or mimalloc) per element,
+//   peak_rss_mb - peak resident memory of the process while the cell ran.
+
+// mi_stl_allocator that also bumps allocation_count, since mimalloc bypasses operator new
+template <typename T>
+struct CountingMimallocAllocator : mi_stl_allocator<T> {
+  template <typename U>
+  struct rebind {
+    using other = CountingMimallocAllocator<U>;
+  };
+
+  CountingMimallocAllocator() noexcept = default;
+
+  template <typename U>
+  CountingMimallocAllocator(const CountingMimallocAllocator<U>&) noexcept {
+  }
+
+  T* allocate(size_t count) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return mi_stl_allocator<T>::allocate(count);
+  }
+};
+
+// A kind of memory: the allocator template, the resource it draws from and
+// how to release that resource between iterations. Glibc is std::allocator
+// over the counting operator new, which calls glibc directly rather than the
+// malloc that mimalloc overrides.
+struct GlibcMemory {
+  static constexpr const char* Name = "Glibc";
+
+  template <typename T>
+  using Allocator = std::allocator<T>;
+
+  struct Resource {
+    void Reset() {
+    }
+  };
+
+  template <typename Alloc>
+  static Alloc Make(Resource&) {
+    return Alloc();
+  }
+};
+
+struct MimallocMemory {
+  static constexpr const char* Name = "Mimalloc";
+
+  template <typename T>
+  using Allocator = CountingMimallocAllocator<T>;
+
+  using Resource = GlibcMemory::Resource;
+
+  template <typename Alloc>
+  static Alloc Make(Resource&) {
+    return Alloc();
+  }
+};
+
+struct ArenaMemory {
+  static constexpr const char* Name = "Arena";
+
+  template <typename T>
+  using Allocator = ArenaAllocator<T>;
+
+  using Resource = MonotonicArena;
+
+  template <typename Alloc>
+  static Alloc Make(Resource& arena) {
+    return Alloc(arena);
+  }
+};
+
+// Vector asks for whole buffers, which PoolAllocator forwards to operator new
+struct PoolMemory {
+  static constexpr const char* Name = "Pool";
+
+  template <typename T>
+  using Allocator = PoolAllocator<T>;
+
+  using Resource = GlibcMemory::Resource;
+
+  template <typename Alloc>
+  static Alloc Make(Resource&) {
+    return Alloc();
+  }
+};
+
+// A container with uniform names for the operations of the workloads. Keys are
+// a permutation of [0, n), so every Map insert adds a node and every erase finds one.
+struct VectorKind {
+  static constexpr const char* Name = "Vector";
+
+  template <typename M>
+  using Allocator = typename M::template Allocator<int>;
+
+  template <typename M>
+  using Type = Vector<int, Allocator<M>>;
+
+  template <typename C>
+  static void Insert(C& vector, int key) {
+    vector.PushBack(key);
+  }
+
+  // Erasing anywhere but the back is quadratic, which would measure memmove
+  template <typename C>
+  static void Erase(C& vector, int) {
+    vector.PopBack();
+  }
+
+  template <typename C>
+  static int64_t Sum(C& vector) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < vector.Size(); ++i) {
+      sum += vector[i];
+    }
+    return sum;
+  }
+};
+
+struct ListKind {
+  static constexpr const char* Name = "List";
+
+  template <typename M>
+  using Allocator = typename M::template Allocator<int>;
+
+  template <typename M>
+  using Type = List<int, Allocator<M>>;
+
+  template <typename C>
+  static void Insert(C& list, int key) {
+    list.PushBack(key);
+  }
+
+  template <typename C>
+  static void Erase(C& list, int) {
+    list.Erase(list.Begin());
+  }
+
+  template <typename C>
+  static int64_t Sum(C& list) {
+    int64_t sum = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      sum += *it;
+    }
+    return sum;
+  }
+};
+
+struct ForwardListKind {
+  static constexpr const char* Name = "ForwardList";
+
+  template <typename M>
+  using Allocator = typename M::template Allocator<int>;
+
+  template <typename M>
+  using Type = ForwardList<int, Allocator<M>>;
+
+  template <typename C>
+  static void Insert(C& list, int key) {
+    list.PushFront(key);
+  }
+
+  template <typename C>
+  static void Erase(C& list, int) {
+    list.PopFront();
+  }
+
+  template <typename C>
+  static int64_t Sum(C& list) {
+    int64_t sum = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      sum += *it;
+    }
+    return sum;
+  }
+};
+
+struct MapKind {
+  static constexpr const char* Name = "Map";
+
+  template <typename M>
+  using Allocator = typename M::template Allocator<std::pair<const int, int>>;
+
+  template <typename M>
+  using Type = Map<int, int, std::less<int>, Allocator<M>>;
+
+  template <typename C>
+  static void Insert(C& map, int key) {
+    map.Insert({key, key});
+  }
+
+  template <typename C>
+  static void Erase(C& map, int key) {
+    map.Erase(key);
+  }
+
+  // Map has no iterators; Values walks the tree in order into a std::vector
+  template <typename C>
+  static int64_t Sum(C& map) {
+    int64_t sum = 0;
+    for (const auto& [key, value] : map.Values(true)) {
+      sum += value;
+    }
+    return sum;
+  }
+};
+
+enum class Workload {
+  Insert,
+  Erase,
+  Clear,
+  Iterate,
+};
+
+std::vector<int> ShuffledKeys(size_t count) {
+  std::vector<int> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  return keys;
+}
+
+// Peak RSS is kept by the kernel for the whole process; writing 5 to
+// clear_refs restarts it from the current RSS, so each cell sees its own peak
+void ResetPeakResident() {
+  std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+double PeakResidentMegabytes() {
+  std::ifstream status("/proc/self/status");
+  std::string field;
+  while (status >> field) {
+    if (field == "VmHWM:") {
+      double kilobytes = 0;
+      status >> kilobytes;
+      return kilobytes / 1024;
+    }
+  }
+  return 0;
+}
+
+// Only the workload itself is timed and counted: filling the container for
+// Erase, Clear and Iterate, destroying it and resetting the memory are not
+template <typename K, typename M, Workload W>
+void BM_Matrix(benchmark::State& state) {
+  using Container = typename K::template Type<M>;
+  using Alloc = typename K::template Allocator<M>;
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  typename M::Resource resource;
+  size_t allocations = 0;
+  ResetPeakResident();
+  for (auto _ : state) {
+    state.PauseTiming();
+    {
+      Container container{M::template Make<Alloc>(resource)};
+      if constexpr (W != Workload::Insert) {
+        for (int key : keys) {
+          K::Insert(container, key);
+        }
+      }
+      size_t before = allocation_count.load(std::memory_order_relaxed);
+      state.ResumeTiming();
+      if constexpr (W == Workload::Insert) {
+        for (int key : keys) {
+          K::Insert(container, key);
+        }
+      } else if constexpr (W == Workload::Erase) {
+        for (int key : keys) {
+          K::Erase(container, key);
+        }
+      } else if constexpr (W == Workload::Clear) {
+        container.Clear();
+      } else {
+        benchmark::DoNotOptimize(K::Sum(container));
+      }
+      state.PauseTiming();
+      allocations += allocation_count.load(std::memory_order_relaxed) - before;
+    }
+    resource.Reset();
+    state.ResumeTiming();
+  }
+  auto ops = static_cast<double>(state.iterations() * state.range(0));
+  state.counters["time/op"] = benchmark::Counter(ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["allocs/op"] = static_cast<double>(allocations) / ops;
+  state.counters["peak_rss_mb"] = PeakResidentMegabytes();
+}
+
+constexpr int64_t Elements = 1 << 16;
+
+template <typename K, typename M, Workload W>
+void RegisterCell(const char* workload) {
+  auto name = fmt::format("BM_Matrix/{}/{}/{}", K::Name, workload, M::Name);
+  benchmark::RegisterBenchmark(name.c_str(), BM_Matrix<K, M, W>)->Arg(Elements);
+}
+
+template <typename K, typename M>
+void RegisterRow() {
+  RegisterCell<K, M, Workload::Insert>("Insert");
+  RegisterCell<K, M, Workload::Erase>("Erase");
+  RegisterCell<K, M, Workload::Clear>("Clear");
+  RegisterCell<K, M, Workload::Iterate>("Iterate");
+}
+
+template <typename K>
+void RegisterContainer() {
+  RegisterRow<K, GlibcMemory>();
+  RegisterRow<K, MimallocMemory>();
+  RegisterRow<K, ArenaMemory>();
+  RegisterRow<K, PoolMemory>();
+}
+
+int main(int argc, char** argv) {
+  RegisterContainer<VectorKind>();
+  RegisterContainer<ListKind>();
+  RegisterContainer<ForwardListKind>();
+  RegisterContainer<MapKind>();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
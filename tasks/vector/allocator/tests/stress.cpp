@@ -0,0 +1,257 @@
+#include "../arena.hpp"
+#include "../pool.hpp"
+#include "../size_class.hpp"
+#include "../../../lists/list/list.hpp"
+#include "../../../tree/bst/map.hpp"
+#include "../../vector/tests/allocation_counter.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+#include <fmt/core.h>
+#include <mimalloc.h>
+
+enum class Memory {
+  Heap,
+  Arena,
+  Pool,
+};
+
+// Allocator of the containers for the stateless kinds of memory
+template <Memory M, typename T>
+using NodeAllocator = std::conditional_t<M == Memory::Pool, PoolAllocator<T>, std::allocator<T>>;
+
+std::vector<int> RandomKeys(size_t count) {
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  std::vector<int> keys(count);
+  for (int& key : keys) {
+    key = dist(mt);
+  }
+  return keys;
+}
+
+void ReportAllocations(benchmark::State& state, size_t before) {
+  state.counters["allocs/iter"] = benchmark::Counter(
+      static_cast<double>(allocation_count.load() - before) / static_cast<double>(state.iterations()));
+}
+
+// Resident set size of the whole process, read from /proc/self/statm
+double ResidentMegabytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0;
+  size_t resident_pages = 0;
+  statm >> total_pages >> resident_pages;
+  return static_cast<double>(resident_pages * sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+// Builds a List<int> of range(0) elements and destroys it, as a request handler would
+template <Memory M>
+void BM_ListBuildTeardown(benchmark::State& state) {
+  MonotonicArena arena;
+  size_t before = allocation_count.load();
+  for (auto _ : state) {
+    if constexpr (M == Memory::Arena) {
+      {
+        List<int, ArenaAllocator<int>> list{ArenaAllocator<int>(arena)};
+        for (int i = 0; i < state.range(0); ++i) {
+          list.PushBack(i);
+        }
+        benchmark::DoNotOptimize(list.Back());
+      }
+      arena.Reset();
+    } else {
+      List<int, NodeAllocator<M, int>> list;
+      for (int i = 0; i < state.range(0); ++i) {
+        list.PushBack(i);
+      }
+      benchmark::DoNotOptimize(list.Back());
+    }
+  }
+  ReportAllocations(state, before);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Same for a Map<int, int> filled with random keys
+template <Memory M>
+void BM_MapBuildTeardown(benchmark::State& state) {
+  using Alloc = ArenaAllocator<std::pair<const int, int>>;
+  std::vector<int> keys = RandomKeys(state.range(0));
+  MonotonicArena arena;
+  size_t before = allocation_count.load();
+  for (auto _ : state) {
+    if constexpr (M == Memory::Arena) {
+      {
+        Map<int, int, std::less<int>, Alloc> map{Alloc(arena)};
+        for (int key : keys) {
+          map.Insert({key, 1});
+        }
+        benchmark::DoNotOptimize(map.Size());
+      }
+      arena.Reset();
+    } else {
+      Map<int, int, std::less<int>, NodeAllocator<M, std::pair<const int, int>>> map;
+      for (int key : keys) {
+        map.Insert({key, 1});
+      }
+      benchmark::DoNotOptimize(map.Size());
+    }
+  }
+  ReportAllocations(state, before);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Fills a List<int> with range(0) elements and erases them one by one, like
+// BM_CustomListErase in tasks/lists/list: one malloc and one free per node
+template <Memory M>
+void BM_ListEraseChurn(benchmark::State& state) {
+  List<int, NodeAllocator<M, int>> list;
+  size_t before = allocation_count.load();
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      list.PushBack(i);
+    }
+    while (!list.IsEmpty()) {
+      list.Erase(list.Begin());
+    }
+  }
+  ReportAllocations(state, before);
+  state.counters["nodes/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * state.range(0)), benchmark::Counter::kIsRate);
+  state.counters["rss_mb"] = ResidentMegabytes();
+}
+
+// Same for a Map<int, int>: random keys are inserted and then erased
+template <Memory M>
+void BM_MapEraseChurn(benchmark::State& state) {
+  std::vector<int> keys = RandomKeys(state.range(0));
+  Map<int, int, std::less<int>, NodeAllocator<M, std::pair<const int, int>>> map;
+  size_t before = allocation_count.load();
+  for (auto _ : state) {
+    for (int key : keys) {
+      map.Insert({key, 1});
+    }
+    for (int key : keys) {
+      if (map.Find(key)) {
+        map.Erase(key);
+      }
+    }
+  }
+  ReportAllocations(state, before);
+  state.counters["nodes/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * state.range(0)), benchmark::Counter::kIsRate);
+  state.counters["rss_mb"] = ResidentMegabytes();
+}
+
+// Single-producer single-consumer ring of message pointers
+class MessageQueue {
+public:
+  void Push(void* message) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    while (tail - head_.load(std::memory_order_acquire) == Capacity) {
+      std::this_thread::yield();
+    }
+    slots_[tail % Capacity] = message;
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+
+  void* Pop() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    while (tail_.load(std::memory_order_acquire) == head) {
+      std::this_thread::yield();
+    }
+    void* message = slots_[head % Capacity];
+    head_.store(head + 1, std::memory_order_release);
+    return message;
+  }
+
+private:
+  static constexpr size_t Capacity = 1024;
+
+  std::array<void*, Capacity> slots_;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+// The real glibc allocator: mimalloc overrides malloc and free, so this calls
+// the __libc_* entry points declared in allocation_counter.hpp
+struct GlibcMalloc {
+  static void* Allocate(size_t size) {
+    return __libc_malloc(size);
+  }
+
+  static void Free(void* ptr, size_t) {
+    __libc_free(ptr);
+  }
+};
+
+struct Mimalloc {
+  static void* Allocate(size_t size) {
+    return mi_malloc(size);
+  }
+
+  static void Free(void* ptr, size_t) {
+    mi_free(ptr);
+  }
+};
+
+struct SizeClass {
+  static void* Allocate(size_t size) {
+    return SizeClassAllocator<char>().allocate(size);
+  }
+
+  static void Free(void* ptr, size_t size) {
+    SizeClassAllocator<char>().deallocate(static_cast<char*>(ptr), size);
+  }
+};
+
+// The benchmark thread allocates messages of range(0) bytes and a consumer
+// thread frees them, so every free is a cross-thread free
+template <typename Malloc>
+void BM_ProducerConsumer(benchmark::State& state) {
+  const auto size = static_cast<size_t>(state.range(0));
+  constexpr int MessagesPerIteration = 4096;
+  MessageQueue queue;
+  std::thread consumer([&queue, size] {
+    while (void* message = queue.Pop()) {
+      Malloc::Free(message, size);
+    }
+  });
+  for (auto _ : state) {
+    for (int i = 0; i < MessagesPerIteration; ++i) {
+      auto message = static_cast<char*>(Malloc::Allocate(size));
+      message[0] = static_cast<char>(i);
+      queue.Push(message);
+    }
+  }
+  queue.Push(nullptr);
+  consumer.join();
+  state.SetItemsProcessed(state.iterations() * MessagesPerIteration);
+}
+
+BENCHMARK_TEMPLATE(BM_ListBuildTeardown, Memory::Heap)->RangeMultiplier(8)->Range(1<<10, 1<<19);
+BENCHMARK_TEMPLATE(BM_ListBuildTeardown, Memory::Arena)->RangeMultiplier(8)->Range(1<<10, 1<<19);
+BENCHMARK_TEMPLATE(BM_ListBuildTeardown, Memory::Pool)->RangeMultiplier(8)->Range(1<<10, 1<<19);
+BENCHMARK_TEMPLATE(BM_MapBuildTeardown, Memory::Heap)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_MapBuildTeardown, Memory::Arena)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_MapBuildTeardown, Memory::Pool)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_ListEraseChurn, Memory::Heap)->RangeMultiplier(8)->Range(1<<10, 1<<17);
+BENCHMARK_TEMPLATE(BM_ListEraseChurn, Memory::Pool)->RangeMultiplier(8)->Range(1<<10, 1<<17);
+BENCHMARK_TEMPLATE(BM_MapEraseChurn, Memory::Heap)->RangeMultiplier(8)->Range(1<<10, 1<<17);
+BENCHMARK_TEMPLATE(BM_MapEraseChurn, Memory::Pool)->RangeMultiplier(8)->Range(1<<10, 1<<17);
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, GlibcMalloc)->RangeMultiplier(4)->Range(16, 1024)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, Mimalloc)->RangeMultiplier(4)->Range(16, 1024)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, SizeClass)->RangeMultiplier(4)->Range(16, 1024)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,180 +1,431 @@
-#include <chrono>
-#include <future>
-#include <map>
-#include <iostream>
-#include <string>
-#include <thread>
+#include "../arena.hpp"
+#include "../pool.hpp"
+#include "../size_class.hpp"
+#include "../../vector/vector.hpp"
+#include "../../vector/vector.cpp"
+#include "../../../lists/list/list.hpp"
+#include "../../../lists/forward/forward_list.hpp"
+#include "../../../tree/bst/map.hpp"
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
-#include "../filesystem/fs.hpp"
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
 
-class FsTest: public testing::Test {
-  protected:
-    void SetUp() override {
-      fs.MakeDir("/mnt/c/Users/Sysoev/VSCodeProjects/", true);
-      fs.CreateFile("/mnt/c/Users/Sysoev/VSCodeProjects/test.txt", false);
-      fs.CreateFile("/mnt/c/Users/Sysoev/VSCodeProjects/test1.txt", false);
-      fs.CreateFile("/mnt/c/Users/Sysoev/VSCodeProjects/test2.txt", false);
-      fs.CreateFile("/mnt/c/Users/Sysoev/VSCodeProjects/test3.txt", false);
-      fs.CreateFile("/mnt/c/Users/Sysoev/test3.txt", false);
-      fs.CreateFile("/mnt/c/Users/test1.txt", false);
-    }
-  
-public:
-  filesystem::Fs fs;
-};
-
-
-TEST(EmptyFsTest, PWDOnRoot) {
-  filesystem::Fs fs;
-  fs.PWD();
-  // expect: "/"
-}
-
-TEST(EmptyFsTest, EmptyListFiles) {
-  filesystem::Fs fs;
-  fs.ListFiles(".");
-  // expect: 
+bool IsAligned(const void* ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
 }
-
-TEST(EmptyFsTest, SimpleMakeDir) {
-  filesystem::Fs fs;
-  fs.MakeDir("/dir", false);
-  fs.ChangeDir("/dir");
-  fs.PWD();
-  // expect: "/dir"
+
+}  // namespace
+
+TEST(MonotonicArenaTest, BumpsThroughOneChunk) {
+    MonotonicArena arena;
+    auto first = static_cast<char*>(arena.Allocate(16, 8));
+    auto second = static_cast<char*>(arena.Allocate(16, 8));
+    ASSERT_EQ(second, first + 16);
+    ASSERT_EQ(arena.ReservedBytes(), MonotonicArena::DefaultChunkSize);
 }
-
-TEST(EmptyFsTest, MakeDirWithFlag) {
-  filesystem::Fs fs;
-  fs.MakeDir("/dir/other_dir", true);
-  fs.ChangeDir("/dir");
-  fs.ChangeDir("other_dir");
-  fs.PWD();
-  // expect: "/dir/other_dir"
-}
-
-TEST(EmptyFsTest, MakeSeveralDirsWithoutFlag) {
-  filesystem::Fs fs;
-  EXPECT_THROW({
-    fs.MakeDir("/dir/other_dir", false);
-  }, filesystem::exceptions::FileNotFoundException);
+
+TEST(MonotonicArenaTest, HonoursAlignment) {
+    MonotonicArena arena;
+    arena.Allocate(1, 1);
+    for (size_t alignment : {2, 8, 16, 64, 4096}) {
+        void* ptr = arena.Allocate(3, alignment);
+        ASSERT_TRUE(IsAligned(ptr, alignment)) << fmt::format("alignment {}", alignment);
+    }
 }
-
-TEST(EmptyFsTest, ChangeDirToNotExistingDir) {
-  filesystem::Fs fs;
-  EXPECT_THROW({
-    fs.ChangeDir("/dir");
-  }, filesystem::exceptions::FileNotFoundException);
+
+TEST(MonotonicArenaTest, GrowsWithNewChunks) {
+    MonotonicArena arena(1024);
+    for (int i = 0; i < 1000; ++i) {
+        auto ptr = static_cast<int64_t*>(arena.Allocate(sizeof(int64_t), alignof(int64_t)));
+        *ptr = i;
+    }
+    ASSERT_GT(arena.ReservedBytes(), size_t{8000});
 }
 
-TEST(EmptyFsTest, SimpleCreateFile) {
-  filesystem::Fs fs;
-  fs.CreateFile("file.txt", false);
-  fs.ListFiles(".");
-  // expect: "file.txt"
+TEST(MonotonicArenaTest, AllocationLargerThanChunk) {
+    MonotonicArena arena(1024);
+    arena.Allocate(100);
+    auto big = static_cast<char*>(arena.Allocate(1 << 20));
+    big[0] = big[(1 << 20) - 1] = 1;
+    ASSERT_GE(arena.ReservedBytes(), size_t{1 << 20});
 }
 
-TEST(EmptyFsTest, ShowFileContent) {
-  filesystem::Fs fs;
-  std::ostringstream oss;
-  oss << "Hello world!\n";
-  fs.CreateFile("file.txt", false);
-  fs.WriteToFile("file.txt", false, oss);
-  fs.ShowFileContent("file.txt");
-  // expect: "Hello world!"
+TEST(MonotonicArenaTest, ResetReusesChunks) {
+    MonotonicArena arena(1024);
+    void* first = arena.Allocate(64);
+    for (int i = 0; i < 100; ++i) {
+        arena.Allocate(100);
+    }
+    size_t reserved = arena.ReservedBytes();
+
+    arena.Reset();
+    ASSERT_EQ(arena.Allocate(64), first);
+    for (int i = 0; i < 100; ++i) {
+        arena.Allocate(100);
+    }
+    ASSERT_EQ(arena.ReservedBytes(), reserved) << "Reset must not drop or add chunks for the same load";
 }
 
-TEST(EmptyFsTest, OverwriteFile) {
-  filesystem::Fs fs;
-  std::ostringstream oss;
-  oss << "Hello world!\n";
-  fs.CreateFile("file.txt", false);
-  fs.WriteToFile("file.txt", false, oss);
-  oss << "Hello Meeeen!\n";
-  fs.WriteToFile("file.txt", true, oss);
-  fs.ShowFileContent("file.txt");
-  // expect: "Hello Meeeen!"
+TEST(MonotonicArenaTest, ResetBeforeFirstAllocation) {
+    MonotonicArena arena;
+    arena.Reset();
+    ASSERT_NE(arena.Allocate(8), nullptr);
 }
 
-TEST(EmptyFsTest, OverwriteFileByCreate) {
-  filesystem::Fs fs;
-  std::ostringstream oss;
-  oss << "Hello world!\n";
-  fs.CreateFile("file.txt", false);
-  fs.WriteToFile("file.txt", false, oss);
-  fs.CreateFile("file.txt", true);
-  fs.ShowFileContent("file.txt");
-  // expect:
+TEST(ArenaAllocatorTest, EqualWhenSharingArena) {
+    MonotonicArena arena;
+    MonotonicArena other;
+    ArenaAllocator<int> alloc(arena);
+    ArenaAllocator<double> rebound(alloc);
+    ASSERT_EQ(ArenaAllocator<int>(rebound), alloc);
+    ASSERT_NE(ArenaAllocator<int>(other), alloc);
 }
 
-TEST(EmptyFsTest, OverwriteFirstCreateFile) {
-  filesystem::Fs fs;
-  std::ostringstream oss;
-  oss << "Hello world!\n";
-  fs.CreateFile("file.txt", true);
-  fs.WriteToFile("file.txt", false, oss);
-  fs.ShowFileContent("file.txt");
-  // expect:
+TEST(ArenaAllocatorTest, Vector) {
+    MonotonicArena arena;
+    Vector<std::string, ArenaAllocator<std::string>> vec{ArenaAllocator<std::string>(arena)};
+    for (int i = 0; i < 1000; ++i) {
+        vec.PushBack(std::to_string(i));
+    }
+    ASSERT_EQ(vec.Size(), 1000);
+    ASSERT_EQ(vec[999], "999");
+    ASSERT_EQ(vec.GetAllocator().Arena(), &arena);
 }
 
-TEST(EmptyFsTest, SimpleRemoveFile) {
-  filesystem::Fs fs;
-  std::ostringstream oss;
-  oss << "Hello world!\n";
-  fs.CreateFile("file.txt", false);
-  fs.RemoveFile("file.txt");
-  fs.ListFiles(".");
-  // expect:
+TEST(ArenaAllocatorTest, List) {
+    MonotonicArena arena;
+    {
+        List<int, ArenaAllocator<int>> list{ArenaAllocator<int>(arena)};
+        for (int i = 0; i < 100; ++i) {
+            list.PushBack(i);
+        }
+        List<int, ArenaAllocator<int>> copy = list;
+        copy.PopFront();
+        ASSERT_EQ(copy.Size(), 99);
+        ASSERT_EQ(copy.Front(), 1);
+        ASSERT_EQ(list.Back(), 99);
+    }
+    ASSERT_EQ(arena.ReservedBytes(), MonotonicArena::DefaultChunkSize);
+    arena.Reset();
 }
 
-TEST(EmptyFsTest, RemoveNotExistFile) {
-  filesystem::Fs fs;
-  EXPECT_THROW({
-    fs.RemoveFile("file.txt");
-  }, filesystem::exceptions::FileNotFoundException);
+TEST(ArenaAllocatorTest, ListSpliceAcrossArenas) {
+    MonotonicArena arena;
+    MonotonicArena other_arena;
+    using Alloc = ArenaAllocator<int>;
+    List<int, Alloc> list{Alloc(arena)};
+    List<int, Alloc> same{Alloc(arena)};
+    List<int, Alloc> other{Alloc(other_arena)};
+    for (int i = 0; i < 4; ++i) {
+        same.PushBack(i);
+        other.PushBack(i + 4);
+    }
+    // Same arena: the nodes are relinked and keep their addresses
+    const int* first = &same.Front();
+    list.Splice(list.End(), same);
+    ASSERT_EQ(&list.Front(), first);
+    // Different arenas: the elements are moved into nodes from our arena
+    const int* foreign = &other.Back();
+    list.Splice(list.End(), other);
+    ASSERT_TRUE(other.IsEmpty());
+    ASSERT_EQ(list.Size(), 8);
+    ASSERT_EQ(list.Back(), 7);
+    ASSERT_NE(&list.Back(), foreign);
+    int expected = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+        ASSERT_EQ(*it, expected++);
+    }
+}
+
+TEST(ArenaAllocatorTest, ForwardList) {
+    MonotonicArena arena;
+    ForwardList<std::string, ArenaAllocator<std::string>> list{ArenaAllocator<std::string>(arena)};
+    list.PushFront("b");
+    list.PushFront("a");
+    ForwardList<std::string, ArenaAllocator<std::string>> moved = std::move(list);
+    ASSERT_TRUE(list.IsEmpty());
+    ASSERT_EQ(moved.Size(), 2);
+    ASSERT_EQ(moved.Front(), "a");
 }
 
+TEST(ArenaAllocatorTest, Map) {
+    MonotonicArena arena;
+    using Alloc = ArenaAllocator<std::pair<const int, int>>;
+    Map<int, int, std::less<int>, Alloc> map{Alloc(arena)};
+    for (int i = 0; i < 100; ++i) {
+        map[(i * 37) % 100] = i;
+    }
+    map.Erase(50);
+    ASSERT_EQ(map.Size(), 99);
+    auto values = map.Values(true);
+    ASSERT_EQ(values.front().first, 0);
+    ASSERT_EQ(values.back().first, 99);
 
-TEST_F(FsTest, SimpleFind) {
-  fs.FindFile("text3.txt");
-  // expect: 
-  // /mnt/c/Users/Sysoev/VSCodeProjects/test3.txt
-  // /mnt/c/Users/Sysoev/test3.txt
-  // 
+    Map<int, int, std::less<int>, Alloc> copy = map;
+    ASSERT_EQ(copy.Size(), 99);
+    ASSERT_EQ(copy.GetAllocator(), map.GetAllocator());
 }
 
-TEST_F(FsTest, FailedChangeDirToFile) {
-  EXPECT_THROW({
-    fs.ChangeDir("/mnt/c/Users/Sysoev/test3.txt");
-  }, filesystem::exceptions::FileNotFoundException);
+TEST(NodePoolTest, ReusesFreedBlocksFirst) {
+    NodePool pool(24, 8);
+    void* first = pool.Allocate();
+    void* second = pool.Allocate();
+    pool.Deallocate(first);
+    pool.Deallocate(second);
+    ASSERT_EQ(pool.Allocate(), second);
+    ASSERT_EQ(pool.Allocate(), first);
 }
 
-TEST_F(FsTest, DirNotExistForCreateFile) {
-  EXPECT_THROW({
-    fs.ChangeDir("/mnt/c/Users/Sysoev/VSCodeProjects");
-    fs.PWD();
-    // expect: /mnt/c/Users/Sysoev/VSCodeProjects/
-    fs.CreateFile("/dir/file.txt", false);
-  }, filesystem::exceptions::FileNotFoundException);
+TEST(NodePoolTest, BlocksDoNotOverlap) {
+    NodePool pool(sizeof(int64_t) * 3, alignof(int64_t));
+    ASSERT_EQ(pool.BlockSize(), 24);
+    std::array<int64_t*, 1000> blocks;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        blocks[i] = static_cast<int64_t*>(pool.Allocate());
+        ASSERT_TRUE(IsAligned(blocks[i], alignof(int64_t)));
+        blocks[i][0] = blocks[i][1] = blocks[i][2] = static_cast<int64_t>(i);
+    }
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        ASSERT_EQ(blocks[i][0], static_cast<int64_t>(i));
+        ASSERT_EQ(blocks[i][2], static_cast<int64_t>(i));
+    }
 }
 
-TEST_F(FsTest, FileNotFound) {
-  EXPECT_THROW({
-    fs.FindFile("file.cpp");
-  }, filesystem::exceptions::FileNotFoundException);
+TEST(NodePoolTest, SmallBlocksHoldTheFreeListLink) {
+    NodePool pool(1, 1);
+    ASSERT_EQ(pool.BlockSize(), sizeof(void*));
 }
 
-TEST_F(FsTest, DeleteRoot) {
-  fs.RemoveFile("/");
-  fs.ListFiles(".");
-  // expect: 
+TEST(NodePoolTest, OverAlignedBlocks) {
+    NodePool pool(100, 64);
+    ASSERT_EQ(pool.BlockSize(), 128);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(IsAligned(pool.Allocate(), 64));
+    }
 }
 
-int main(int argc, char **argv) {
-  ::testing::InitGoogleTest(&argc, argv);
+TEST(NodePoolTest, SlabsDoubleInSize) {
+    NodePool pool(32, 8);
+    for (size_t i = 0; i < NodePool::FirstSlabBlocks; ++i) {
+        pool.Allocate();
+    }
+    size_t first_slab = pool.ReservedBytes();
+    pool.Allocate();
+    ASSERT_GT(pool.ReservedBytes() - first_slab, first_slab * 3 / 2);
+}
+
+template <typename Allocator>
+class PoolAllocatorTest : public testing::Test {};
+
+using PoolAllocators = testing::Types<PoolAllocator<int, PoolCache::Shared>, PoolAllocator<int, PoolCache::PerThread>>;
+TYPED_TEST_SUITE(PoolAllocatorTest, PoolAllocators);
 
-  return RUN_ALL_TESTS();
-}
\ No newline at end of file
+TYPED_TEST(PoolAllocatorTest, NodeContainers) {
+    using IntAllocator = TypeParam;
+    using PairAllocator = typename std::allocator_traits<TypeParam>::template rebind_alloc<std::pair<const int, int>>;
+
+    List<int, IntAllocator> list;
+    ForwardList<int, IntAllocator> forward;
+    Map<int, int, std::less<int>, PairAllocator> map;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            list.PushBack(i);
+            forward.PushFront(i);
+            map[i] = i;
+        }
+        ASSERT_EQ(list.Back(), 999);
+        ASSERT_EQ(forward.Front(), 999);
+        for (int i = 0; i < 1000; i += 2) {
+            map.Erase(i);
+        }
+        ASSERT_EQ(map.Size(), 500);
+        list.Clear();
+        forward.Clear();
+        map.Clear();
+    }
+}
+
+TYPED_TEST(PoolAllocatorTest, FreeOnAnotherThread) {
+    List<int, TypeParam> list;
+    std::thread producer([&list] {
+        List<int, TypeParam> local;
+        for (int i = 0; i < 10000; ++i) {
+            local.PushBack(i);
+        }
+        list = std::move(local);
+    });
+    producer.join();
+    ASSERT_EQ(list.Size(), 10000);
+    ASSERT_EQ(list.Back(), 9999);
+    list.Clear();
+}
+
+TEST(PoolAllocatorTest, ExitingThreadsReturnTheirCache) {
+    struct Block {
+        char data[72];
+    };
+    using Allocator = PoolAllocator<Block, PoolCache::PerThread>;
+
+    auto churn = [] {
+        Allocator alloc;
+        std::array<Block*, 500> blocks;
+        for (Block*& block : blocks) {
+            block = alloc.allocate(1);
+        }
+        for (Block* block : blocks) {
+            alloc.deallocate(block, 1);
+        }
+    };
+    std::thread(churn).join();
+    size_t reserved = Allocator::ReservedBytes();
+    for (int i = 0; i < 10; ++i) {
+        std::thread(churn).join();
+    }
+    ASSERT_EQ(Allocator::ReservedBytes(), reserved);
+}
+
+TEST(PoolAllocatorTest, VectorBuffersBypassThePool) {
+    Vector<int, PoolAllocator<int>> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_EQ(vec[999], 999);
+}
+
+TEST(SizeClassAllocatorTest, SizeClasses) {
+    ASSERT_EQ(detail::SizeClasses[detail::SizeClassOf(1)], 16);
+    ASSERT_EQ(detail::SizeClasses[detail::SizeClassOf(16)], 16);
+    ASSERT_EQ(detail::SizeClasses[detail::SizeClassOf(17)], 32);
+    ASSERT_EQ(detail::SizeClasses[detail::SizeClassOf(129)], 160);
+    ASSERT_EQ(detail::SizeClasses[detail::SizeClassOf(700)], 768);
+    ASSERT_EQ(detail::SizeClasses[detail::SizeClassOf(1024)], 1024);
+}
+
+TEST(SizeClassAllocatorTest, ReusesFreedBlocks) {
+    struct Object {
+        char data[40];
+    };
+    SizeClassAllocator<Object> alloc;
+    Object* first = alloc.allocate(1);
+    ASSERT_TRUE(IsAligned(first, 16));
+    alloc.deallocate(first, 1);
+    Object* second = alloc.allocate(1);
+    ASSERT_EQ(first, second);
+    alloc.deallocate(second, 1);
+}
+
+TEST(SizeClassAllocatorTest, Containers) {
+    Vector<std::string, SizeClassAllocator<std::string>> vec;
+    List<int, SizeClassAllocator<int>> list;
+    ForwardList<int, SizeClassAllocator<int>> forward;
+    Map<int, std::string, std::less<int>, SizeClassAllocator<std::pair<const int, std::string>>> map;
+    for (int i = 0; i < 5000; ++i) {
+        vec.PushBack(std::to_string(i));
+        list.PushBack(i);
+        forward.PushFront(i);
+        map[(i * 7919) % 5000] = std::to_string(i);
+    }
+    ASSERT_EQ(vec[4999], "4999");
+    ASSERT_EQ(list.Back(), 4999);
+    ASSERT_EQ(forward.Front(), 4999);
+    ASSERT_EQ(map.Size(), 5000);
+    for (int i = 0; i < 5000; i += 3) {
+        map.Erase(i);
+    }
+    ASSERT_FALSE(map.Find(0));
+    ASSERT_TRUE(map.Find(1));
+}
+
+TEST(SizeClassAllocatorTest, RemoteFreesReturnToTheOwner) {
+    struct Message {
+        char data[600];
+    };
+    std::thread producer([] {
+        SizeClassAllocator<Message> alloc;
+        std::array<Message*, 300> sent;
+        for (Message*& message : sent) {
+            message = alloc.allocate(1);
+        }
+        std::thread consumer([&sent] {
+            SizeClassAllocator<Message> alloc;
+            for (Message* message : sent) {
+                alloc.deallocate(message, 1);
+            }
+        });
+        consumer.join();
+
+        // The consumer's frees went to our remote queue, so we get the same blocks back
+        std::sort(sent.begin(), sent.end());
+        for (size_t i = 0; i < sent.size(); ++i) {
+            Message* message = alloc.allocate(1);
+            EXPECT_TRUE(std::binary_search(sent.begin(), sent.end(), message));
+        }
+    });
+    producer.join();
+}
+
+TEST(SizeClassAllocatorTest, FreeAfterOwnerExited) {
+    List<int, SizeClassAllocator<int>> list;
+    for (int round = 0; round < 5; ++round) {
+        std::thread([&list] {
+            List<int, SizeClassAllocator<int>> local;
+            for (int i = 0; i < 1000; ++i) {
+                local.PushBack(i);
+            }
+            local.Swap(list);
+        }).join();
+        ASSERT_EQ(list.Size(), 1000);
+    }
+    list.Clear();
+}
+
+TEST(SizeClassAllocatorTest, ThreadsPassMessagesInARing) {
+    constexpr int Threads = 4;
+    constexpr int Messages = 20000;
+    std::array<std::atomic<int*>, Threads> mailboxes{};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([&mailboxes, t] {
+            SizeClassAllocator<int> alloc;
+            std::atomic<int*>& outgoing = mailboxes[t];
+            std::atomic<int*>& incoming = mailboxes[(t + 1) % Threads];
+            int sent = 0;
+            int received = 0;
+            while (sent < Messages || received < Messages) {
+                bool progress = false;
+                if (sent < Messages && outgoing.load(std::memory_order_acquire) == nullptr) {
+                    int* message = alloc.allocate(1);
+                    *message = sent++;
+                    outgoing.store(message, std::memory_order_release);
+                    progress = true;
+                }
+                if (int* message = incoming.exchange(nullptr, std::memory_order_acquire)) {
+                    EXPECT_EQ(*message, received++);
+                    alloc.deallocate(message, 1);
+                    progress = true;
+                }
+                if (!progress) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
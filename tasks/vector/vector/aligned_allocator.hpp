@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Allocator whose buffers start at a multiple of Alignment bytes
+// (64 is a cache line and the widest SIMD register on x86)
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    static_assert(std::has_single_bit(Alignment), "alignment must be a power of two");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    static constexpr std::align_val_t BufferAlignment{std::max(Alignment, alignof(T))};
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {
+    }
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T), BufferAlignment));
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        ::operator delete(ptr, BufferAlignment);
+    }
+
+    friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) noexcept {
+        return true;
+    }
+};
+
+namespace detail {
+
+inline constexpr size_t HugePageSize = size_t{1} << 21;
+
+inline size_t RoundUpToHugePages(size_t bytes) noexcept {
+    return (bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+}
+
+// Tries, in order: explicit huge pages (MAP_HUGETLB, needs vm.nr_hugepages),
+// a 2 MB aligned mapping marked MADV_HUGEPAGE for transparent huge pages,
+// and finally the same mapping with regular pages if THP is not available
+inline void* MapHugePages(size_t bytes) {
+    size_t length = RoundUpToHugePages(bytes);
+#if defined(__linux__)
+#if defined(MAP_HUGETLB)
+    void* explicit_pages = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (explicit_pages != MAP_FAILED) {
+        return explicit_pages;
+    }
+#endif
+    // Over-map by a huge page and trim both ends, so the kernel can back every 2 MB with one page
+    void* raw = mmap(nullptr, length + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    auto begin = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (begin + HugePageSize - 1) / HugePageSize * HugePageSize;
+    if (aligned != begin) {
+        munmap(raw, aligned - begin);
+    }
+    munmap(reinterpret_cast<void*>(aligned + length), begin + HugePageSize - aligned);
+#if defined(MADV_HUGEPAGE)
+    // Failure only means regular pages
+    madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<void*>(aligned);
+#else
+    return ::operator new(length, std::align_val_t{HugePageSize});
+#endif
+}
+
+inline void UnmapHugePages(void* ptr, size_t bytes) noexcept {
+#if defined(__linux__)
+    munmap(ptr, RoundUpToHugePages(bytes));
+#else
+    ::operator delete(ptr, std::align_val_t{HugePageSize});
+#endif
+}
+
+}  // namespace detail
+
+// AlignedAllocator that puts buffers of at least 2 MB on huge pages to cut TLB misses.
+// Smaller buffers come from the regular heap.
+template <typename T, size_t Alignment = 64>
+struct HugePageAllocator : AlignedAllocator<T, Alignment> {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Alignment>;
+    };
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Alignment>&) noexcept {
+    }
+
+    static bool UsesHugePages(size_t count) noexcept {
+        return count * sizeof(T) >= detail::HugePageSize;
+    }
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if (UsesHugePages(count)) {
+            return static_cast<T*>(detail::MapHugePages(count * sizeof(T)));
+        }
+        return AlignedAllocator<T, Alignment>::allocate(count);
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (UsesHugePages(count)) {
+            detail::UnmapHugePages(ptr, count * sizeof(T));
+            return;
+        }
+        AlignedAllocator<T, Alignment>::deallocate(ptr, count);
+    }
+
+    friend bool operator==(const HugePageAllocator&, const HugePageAllocator&) noexcept {
+        return true;
+    }
+};
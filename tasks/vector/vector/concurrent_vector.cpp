@@ -0,0 +1,160 @@
+#include "concurrent_vector.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+template <typename T, size_t FirstSegmentSize>
+T& ConcurrentVector<T, FirstSegmentSize>::operator[](size_t pos) noexcept {
+    return *Slot(pos);
+}
+
+template <typename T, size_t FirstSegmentSize>
+const T& ConcurrentVector<T, FirstSegmentSize>::operator[](size_t pos) const noexcept {
+    return *Slot(pos);
+}
+
+template <typename T, size_t FirstSegmentSize>
+bool ConcurrentVector<T, FirstSegmentSize>::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+template <typename T, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, FirstSegmentSize>::Size() const noexcept {
+    return published_.load(std::memory_order_acquire);
+}
+
+template <typename T, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, FirstSegmentSize>::Capacity() const noexcept {
+    size_t capacity = 0;
+    // Not break: after a failed allocation a later segment may still be installed
+    for (size_t segment = 0; segment < MaxSegments; ++segment) {
+        if (!segments_[segment].load(std::memory_order_acquire)) {
+            continue;
+        }
+        capacity += SegmentSize(segment);
+    }
+    return capacity;
+}
+
+template <typename T, size_t FirstSegmentSize>
+void ConcurrentVector<T, FirstSegmentSize>::Reserve(size_t new_cap) {
+    if (new_cap == 0) {
+        return;
+    }
+    for (size_t segment = 0; segment <= SegmentIndex(new_cap - 1); ++segment) {
+        EnsureSegment(segment);
+    }
+}
+
+template <typename T, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, FirstSegmentSize>::PushBack(T value) {
+    size_t pos = reserved_.fetch_add(1, std::memory_order_relaxed);
+    std::byte* block = EnsureSegment(SegmentIndex(pos));
+    size_t offset = SegmentOffset(pos);
+    std::construct_at(Elements(block) + offset, std::move(value));
+    // Fast path: every earlier element is already published, so publish ours directly.
+    // Otherwise leave a ready flag for whoever publishes our predecessor.
+    size_t expected = pos;
+    if (!published_.compare_exchange_strong(expected, pos + 1)) {
+        ReadyFlags(block, SegmentIndex(pos))[offset].store(true);
+    }
+    AdvancePublished();
+    return pos;
+}
+
+template <typename T, size_t FirstSegmentSize>
+template <class... Args>
+size_t ConcurrentVector<T, FirstSegmentSize>::EmplaceBack(Args&&... args) {
+    return PushBack(T(std::forward<Args>(args)...));
+}
+
+template <typename T, size_t FirstSegmentSize>
+ConcurrentVector<T, FirstSegmentSize>::~ConcurrentVector() {
+    // A segment whose allocation threw leaves a gap, and other producers may
+    // have installed later segments past it: free every installed one
+    for (size_t segment = 0; segment < MaxSegments; ++segment) {
+        std::byte* block = segments_[segment].load(std::memory_order_acquire);
+        if (!block) {
+            continue;
+        }
+        size_t count = SegmentSize(segment);
+        size_t first = count - FirstSegmentSize;  // index of the segment's first element
+        size_t size = published_.load(std::memory_order_relaxed);
+        if (size > first) {
+            std::destroy_n(Elements(block), std::min(count, size - first));
+        }
+        std::destroy_n(ReadyFlags(block, segment), count);
+        ::operator delete(block, std::align_val_t{alignof(T)});
+    }
+}
+
+template <typename T, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, FirstSegmentSize>::SegmentIndex(size_t pos) noexcept {
+    // Segment k holds positions [F * (2^k - 1), F * (2^(k+1) - 1)), i.e. pos + F has bit k + log F set
+    return std::bit_width(pos + FirstSegmentSize) - 1 - FirstSegmentBits;
+}
+
+template <typename T, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, FirstSegmentSize>::SegmentOffset(size_t pos) noexcept {
+    return pos + FirstSegmentSize - SegmentSize(SegmentIndex(pos));
+}
+
+template <typename T, size_t FirstSegmentSize>
+constexpr size_t ConcurrentVector<T, FirstSegmentSize>::SegmentSize(size_t segment) noexcept {
+    return FirstSegmentSize << segment;
+}
+
+template <typename T, size_t FirstSegmentSize>
+T* ConcurrentVector<T, FirstSegmentSize>::Elements(std::byte* block) noexcept {
+    return reinterpret_cast<T*>(block);
+}
+
+template <typename T, size_t FirstSegmentSize>
+std::atomic<bool>* ConcurrentVector<T, FirstSegmentSize>::ReadyFlags(std::byte* block, size_t segment) noexcept {
+    return reinterpret_cast<std::atomic<bool>*>(block + SegmentSize(segment) * sizeof(T));
+}
+
+template <typename T, size_t FirstSegmentSize>
+std::byte* ConcurrentVector<T, FirstSegmentSize>::EnsureSegment(size_t segment) {
+    std::byte* block = segments_[segment].load(std::memory_order_acquire);
+    if (block) {
+        return block;
+    }
+    size_t count = SegmentSize(segment);
+    auto fresh = static_cast<std::byte*>(
+        ::operator new(count * (sizeof(T) + sizeof(std::atomic<bool>)), std::align_val_t{alignof(T)}));
+    std::uninitialized_value_construct_n(ReadyFlags(fresh, segment), count);
+    if (segments_[segment].compare_exchange_strong(block, fresh)) {
+        return fresh;
+    }
+    // Another producer installed the segment first
+    std::destroy_n(ReadyFlags(fresh, segment), count);
+    ::operator delete(fresh, std::align_val_t{alignof(T)});
+    return block;
+}
+
+template <typename T, size_t FirstSegmentSize>
+T* ConcurrentVector<T, FirstSegmentSize>::Slot(size_t pos) const noexcept {
+    std::byte* block = segments_[SegmentIndex(pos)].load(std::memory_order_acquire);
+    return Elements(block) + SegmentOffset(pos);
+}
+
+template <typename T, size_t FirstSegmentSize>
+void ConcurrentVector<T, FirstSegmentSize>::AdvancePublished() noexcept {
+    // Segment pointers, ready flags and published_ use sequentially consistent accesses:
+    // when the owner of the next slot marks it ready concurrently with our CAS, at least
+    // one of us sees the other's write, so published_ never stops short of a ready element
+    size_t published = published_.load();
+    while (published < reserved_.load()) {
+        size_t segment = SegmentIndex(published);
+        std::byte* block = segments_[segment].load();
+        if (!block || !ReadyFlags(block, segment)[SegmentOffset(published)].load()) {
+            // The owner of that slot is still constructing it and will advance published_ itself
+            return;
+        }
+        // On failure `published` is reloaded and we retry from there
+        published_.compare_exchange_weak(published, published + 1);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+// ConcurrentVector<T> is an append-only vector for many producer threads.
+//
+// Elements live in segments of FirstSegmentSize, 2 * FirstSegmentSize,
+// 4 * FirstSegmentSize, ... elements that are never reallocated, so an
+// element keeps its address for the lifetime of the vector.
+//   * PushBack/EmplaceBack are lock-free and return the index of the new element;
+//   * Size() counts the published prefix: every element below it is fully
+//     constructed and visible to the thread that read Size();
+//   * operator[] is wait-free for any published index and for indices
+//     returned by PushBack to the calling thread.
+// Destruction, like for any other object, must not race with other calls.
+// If allocating a new segment throws, the slot reserved for the element stays
+// empty, Size() never grows past it and later elements are not destroyed;
+// the memory of every allocated segment is still freed.
+template <typename T, size_t FirstSegmentSize = 64>
+class ConcurrentVector {
+    static_assert(std::has_single_bit(FirstSegmentSize), "segment sizes must be powers of two");
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "elements are moved into reserved slots, which must not fail");
+
+public:
+    ConcurrentVector() = default;
+
+    ConcurrentVector(const ConcurrentVector& other) = delete;
+
+    ConcurrentVector& operator=(const ConcurrentVector& other) = delete;
+
+    T& operator[](size_t pos) noexcept;
+
+    const T& operator[](size_t pos) const noexcept;
+
+    bool IsEmpty() const noexcept;
+
+    size_t Size() const noexcept;
+
+    // Total size of the allocated segments
+    size_t Capacity() const noexcept;
+
+    // Allocates segments up front so the first new_cap pushes never allocate
+    void Reserve(size_t new_cap);
+
+    size_t PushBack(T value);
+
+    // The element is constructed before a slot is reserved, so a throwing
+    // constructor leaves the vector untouched
+    template <class... Args>
+    size_t EmplaceBack(Args&&... args);
+
+    ~ConcurrentVector();
+
+private:
+    static constexpr size_t FirstSegmentBits = std::countr_zero(FirstSegmentSize);
+
+    static constexpr size_t MaxSegments = sizeof(size_t) * 8 - FirstSegmentBits;
+
+    static size_t SegmentIndex(size_t pos) noexcept;
+
+    static size_t SegmentOffset(size_t pos) noexcept;
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept;
+
+    // Every segment is one block: element storage followed by a ready flag per element
+    static T* Elements(std::byte* block) noexcept;
+
+    static std::atomic<bool>* ReadyFlags(std::byte* block, size_t segment) noexcept;
+
+    // Returns the segment block, allocating and publishing it if nobody has yet
+    std::byte* EnsureSegment(size_t segment);
+
+    // Pointer to the storage of an element whose segment is already allocated
+    T* Slot(size_t pos) const noexcept;
+
+    // Moves published_ past every ready element; any producer may finish the job of another
+    void AdvancePublished() noexcept;
+
+    std::atomic<std::byte*> segments_[MaxSegments] = {};
+    std::atomic<size_t> reserved_ = 0;
+    std::atomic<size_t> published_ = 0;
+};
@@ -0,0 +1,180 @@
+#include "cow_vector.hpp"
+
+#include <algorithm>
+#include <utility>
+
+template <typename T>
+CowVector<T>::CowVector() : shared_(nullptr) {
+}
+
+template <typename T>
+CowVector<T>::CowVector(size_t count, const T& value) : CowVector(Vector<T>(count, value)) {
+}
+
+template <typename T>
+CowVector<T>::CowVector(std::initializer_list<T> init) : CowVector(Vector<T>(init)) {
+}
+
+template <typename T>
+CowVector<T>::CowVector(Vector<T>&& vec) : shared_(new Shared{1, std::move(vec)}) {
+}
+
+template <typename T>
+CowVector<T>::CowVector(const CowVector& other) noexcept : shared_(other.shared_) {
+    if (shared_) {
+        // Only the decrements order accesses to the elements
+        shared_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+auto CowVector<T>::operator=(const CowVector& other) noexcept -> CowVector& {
+    if (shared_ != other.shared_) {
+        CowVector copy(other);
+        Swap(copy);
+    }
+    return *this;
+}
+
+template <typename T>
+CowVector<T>::CowVector(CowVector&& other) noexcept : shared_(std::exchange(other.shared_, nullptr)) {
+}
+
+template <typename T>
+auto CowVector<T>::operator=(CowVector&& other) noexcept -> CowVector& {
+    if (this != &other) {
+        Release();
+        shared_ = std::exchange(other.shared_, nullptr);
+    }
+    return *this;
+}
+
+template <typename T>
+const T& CowVector<T>::operator[](size_t pos) const noexcept {
+    return Data()[pos];
+}
+
+template <typename T>
+T& CowVector<T>::operator[](size_t pos) {
+    return Exclusive()[pos];
+}
+
+template <typename T>
+const T& CowVector<T>::Front() const noexcept {
+    return Data()[0];
+}
+
+template <typename T>
+const T& CowVector<T>::Back() const noexcept {
+    return Data()[Size() - 1];
+}
+
+template <typename T>
+const T* CowVector<T>::Data() const noexcept {
+    return shared_ ? shared_->elements.Data() : nullptr;
+}
+
+template <typename T>
+bool CowVector<T>::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+template <typename T>
+size_t CowVector<T>::Size() const noexcept {
+    return shared_ ? shared_->elements.Size() : 0;
+}
+
+template <typename T>
+size_t CowVector<T>::Capacity() const noexcept {
+    return shared_ ? shared_->elements.Capacity() : 0;
+}
+
+template <typename T>
+bool CowVector<T>::IsShared() const noexcept {
+    return shared_ && shared_->refs.load(std::memory_order_acquire) > 1;
+}
+
+template <typename T>
+void CowVector<T>::Reserve(size_t new_cap) {
+    if (new_cap > Capacity()) {
+        Exclusive(new_cap).Reserve(new_cap);
+    }
+}
+
+template <typename T>
+void CowVector<T>::Clear() noexcept {
+    if (IsShared()) {
+        // Nothing to copy: just let go of the shared buffer
+        Release();
+    } else if (shared_) {
+        shared_->elements.Clear();
+    }
+}
+
+template <typename T>
+void CowVector<T>::Insert(size_t pos, T value) {
+    Exclusive(Size() + 1).Insert(pos, std::move(value));
+}
+
+template <typename T>
+void CowVector<T>::Erase(size_t begin_pos, size_t end_pos) {
+    Exclusive().Erase(begin_pos, end_pos);
+}
+
+template <typename T>
+void CowVector<T>::PushBack(T value) {
+    Exclusive(Size() + 1).PushBack(std::move(value));
+}
+
+template <typename T>
+template <class... Args>
+void CowVector<T>::EmplaceBack(Args&&... args) {
+    Exclusive(Size() + 1).EmplaceBack(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void CowVector<T>::PopBack() {
+    Exclusive().PopBack();
+}
+
+template <typename T>
+void CowVector<T>::Resize(size_t count, const T& value) {
+    Exclusive(count).Resize(count, value);
+}
+
+template <typename T>
+void CowVector<T>::Swap(CowVector& other) noexcept {
+    std::swap(shared_, other.shared_);
+}
+
+template <typename T>
+CowVector<T>::~CowVector() {
+    Release();
+}
+
+template <typename T>
+Vector<T>& CowVector<T>::Exclusive(size_t min_cap) {
+    // Acquire: reads of the buffer by the copies released since happen before our writes
+    if (shared_ && shared_->refs.load(std::memory_order_acquire) == 1) {
+        return shared_->elements;
+    }
+    Vector<T> elements;
+    if (shared_) {
+        // Keep the capacity of the shared buffer so the copy does not reallocate right away
+        const Vector<T>& old = shared_->elements;
+        elements.Reserve(std::max(min_cap, old.Capacity()));
+        elements.AppendRange(old.Data(), old.Data() + old.Size());
+    }
+    Shared* own = new Shared{1, std::move(elements)};
+    Release();
+    shared_ = own;
+    return shared_->elements;
+}
+
+template <typename T>
+void CowVector<T>::Release() noexcept {
+    if (shared_ && shared_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete shared_;
+    }
+    shared_ = nullptr;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+
+#include "vector.hpp"
+
+// CowVector<T> is a copy-on-write Vector: copies share one refcounted buffer,
+// so taking a snapshot costs an atomic increment instead of copying every
+// element. The first modifying call on a shared vector copies the elements
+// into a buffer of its own; the other copies keep seeing the old contents.
+//
+// The refcount is atomic, so copies may be handed to other threads and read
+// or modified there, but one CowVector object must not be used by several
+// threads at once, exactly like Vector. Non-const operator[] is a modifying
+// call: readers should access snapshots through a const CowVector.
+template <typename T>
+class CowVector {
+public:
+    CowVector();
+
+    CowVector(size_t count, const T& value);
+
+    CowVector(std::initializer_list<T> init);
+
+    // Takes over the elements of vec without copying them
+    explicit CowVector(Vector<T>&& vec);
+
+    CowVector(const CowVector& other) noexcept;
+
+    CowVector& operator=(const CowVector& other) noexcept;
+
+    CowVector(CowVector&& other) noexcept;
+
+    CowVector& operator=(CowVector&& other) noexcept;
+
+    const T& operator[](size_t pos) const noexcept;
+
+    // Copies the elements first if the buffer is shared. The reference is
+    // invalidated by copying the vector: the copy shares the same buffer, so
+    // writing through a kept reference would change the copy as well. Take a
+    // fresh reference after every copy.
+    T& operator[](size_t pos);
+
+    const T& Front() const noexcept;
+
+    const T& Back() const noexcept;
+
+    const T* Data() const noexcept;
+
+    bool IsEmpty() const noexcept;
+
+    size_t Size() const noexcept;
+
+    size_t Capacity() const noexcept;
+
+    // True if other copies share the buffer, i.e. the next modification copies it
+    bool IsShared() const noexcept;
+
+    void Reserve(size_t new_cap);
+
+    void Clear() noexcept;
+
+    void Insert(size_t pos, T value);
+
+    void Erase(size_t begin_pos, size_t end_pos);
+
+    void PushBack(T value);
+
+    template <class... Args>
+    void EmplaceBack(Args&&... args);
+
+    void PopBack();
+
+    void Resize(size_t count, const T& value);
+
+    void Swap(CowVector& other) noexcept;
+
+    ~CowVector();
+
+private:
+    struct Shared {
+        std::atomic<size_t> refs;
+        Vector<T> elements;
+    };
+
+    // Makes the buffer exclusively ours, with room for at least min_cap elements,
+    // and returns it for modification
+    Vector<T>& Exclusive(size_t min_cap = 0);
+
+    void Release() noexcept;
+
+    Shared* shared_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename T>
+void swap(CowVector<T>& a, CowVector<T>& b) {
+    a.Swap(b);
+}
+}  // namespace std
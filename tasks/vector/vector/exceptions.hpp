@@ -0,0 +1,30 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+class MmapVectorException : public std::exception {
+public:
+    explicit MmapVectorException(const std::string& text) : error_message_(text) {
+    }
+
+    const char* what() const noexcept override {
+        return error_message_.c_str();
+    }
+
+private:
+    std::string error_message_;
+};
+
+class SerializationException : public std::exception {
+public:
+    explicit SerializationException(const std::string& text) : error_message_(text) {
+    }
+
+    const char* what() const noexcept override {
+        return error_message_.c_str();
+    }
+
+private:
+    std::string error_message_;
+};
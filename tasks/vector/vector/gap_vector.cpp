@@ -0,0 +1,237 @@
+#include "gap_vector.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+template <typename T>
+GapVector<T>::GapVector() : data_(nullptr), gap_begin_(0), gap_end_(0), capacity_(0) {
+}
+
+template <typename T>
+GapVector<T>::GapVector(size_t count, const T& value) : GapVector() {
+    Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        PushBack(value);
+    }
+}
+
+template <typename T>
+GapVector<T>::GapVector(std::initializer_list<T> init) : GapVector() {
+    Reserve(init.size());
+    for (const T& value : init) {
+        PushBack(value);
+    }
+}
+
+template <typename T>
+GapVector<T>::GapVector(const GapVector& other) : GapVector() {
+    Reserve(other.Size());
+    for (size_t i = 0; i < other.Size(); ++i) {
+        PushBack(other[i]);
+    }
+}
+
+template <typename T>
+auto GapVector<T>::operator=(const GapVector& other) -> GapVector& {
+    if (this != &other) {
+        GapVector copy(other);
+        Swap(copy);
+    }
+    return *this;
+}
+
+template <typename T>
+GapVector<T>::GapVector(GapVector&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      gap_begin_(std::exchange(other.gap_begin_, 0)),
+      gap_end_(std::exchange(other.gap_end_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)) {
+}
+
+template <typename T>
+auto GapVector<T>::operator=(GapVector&& other) noexcept -> GapVector& {
+    if (this != &other) {
+        GapVector moved(std::move(other));
+        Swap(moved);
+    }
+    return *this;
+}
+
+template <typename T>
+T& GapVector<T>::operator[](size_t pos) noexcept {
+    return pos < gap_begin_ ? data_[pos] : data_[pos + GapSize()];
+}
+
+template <typename T>
+const T& GapVector<T>::operator[](size_t pos) const noexcept {
+    return pos < gap_begin_ ? data_[pos] : data_[pos + GapSize()];
+}
+
+template <typename T>
+T& GapVector<T>::Front() noexcept {
+    return (*this)[0];
+}
+
+template <typename T>
+T& GapVector<T>::Back() noexcept {
+    return (*this)[Size() - 1];
+}
+
+template <typename T>
+bool GapVector<T>::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+template <typename T>
+size_t GapVector<T>::Size() const noexcept {
+    return capacity_ - GapSize();
+}
+
+template <typename T>
+size_t GapVector<T>::Capacity() const noexcept {
+    return capacity_;
+}
+
+template <typename T>
+size_t GapVector<T>::GapPosition() const noexcept {
+    return gap_begin_;
+}
+
+template <typename T>
+void GapVector<T>::Reserve(size_t new_cap) {
+    if (new_cap > capacity_) {
+        Reallocate(new_cap);
+    }
+}
+
+template <typename T>
+void GapVector<T>::Clear() noexcept {
+    std::destroy(data_, data_ + gap_begin_);
+    std::destroy(data_ + gap_end_, data_ + capacity_);
+    gap_begin_ = 0;
+    gap_end_ = capacity_;
+}
+
+template <typename T>
+void GapVector<T>::Insert(size_t pos, T value) {
+    pos = std::min(pos, Size());
+    GrowIfFull();
+    MoveGap(pos);
+    AllocTraits::construct(alloc_, data_ + gap_begin_, std::move(value));
+    ++gap_begin_;
+}
+
+template <typename T>
+void GapVector<T>::Erase(size_t begin_pos, size_t end_pos) {
+    end_pos = std::min(end_pos, Size());
+    if (begin_pos >= end_pos) {
+        return;
+    }
+    size_t count = end_pos - begin_pos;
+    // Bring the gap to whichever end of the range is closer, then widen it over the range
+    if (std::max(gap_begin_, begin_pos) - std::min(gap_begin_, begin_pos) <=
+        std::max(gap_begin_, end_pos) - std::min(gap_begin_, end_pos)) {
+        MoveGap(begin_pos);
+        std::destroy(data_ + gap_end_, data_ + gap_end_ + count);
+        gap_end_ += count;
+    } else {
+        MoveGap(end_pos);
+        std::destroy(data_ + begin_pos, data_ + end_pos);
+        gap_begin_ = begin_pos;
+    }
+}
+
+template <typename T>
+void GapVector<T>::PushBack(T value) {
+    Insert(Size(), std::move(value));
+}
+
+template <typename T>
+template <class... Args>
+void GapVector<T>::EmplaceBack(Args&&... args) {
+    // args may refer to our own elements, which growing or moving the gap relocates
+    Insert(Size(), T(std::forward<Args>(args)...));
+}
+
+template <typename T>
+void GapVector<T>::PopBack() {
+    Erase(Size() - 1, Size());
+}
+
+template <typename T>
+void GapVector<T>::Swap(GapVector& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(gap_begin_, other.gap_begin_);
+    std::swap(gap_end_, other.gap_end_);
+    std::swap(capacity_, other.capacity_);
+}
+
+template <typename T>
+GapVector<T>::~GapVector() {
+    Clear();
+    if (data_) {
+        AllocTraits::deallocate(alloc_, data_, capacity_);
+    }
+}
+
+template <typename T>
+size_t GapVector<T>::GapSize() const noexcept {
+    return gap_end_ - gap_begin_;
+}
+
+template <typename T>
+void GapVector<T>::RelocateOverlapping(T* from, size_t count, T* to) noexcept {
+    if (count == 0 || from == to) {
+        return;
+    }
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        std::memmove(static_cast<void*>(to), from, count * sizeof(T));
+    } else if (to < from) {
+        for (size_t i = 0; i < count; ++i) {
+            std::construct_at(to + i, std::move(from[i]));
+            std::destroy_at(from + i);
+        }
+    } else {
+        for (size_t i = count; i > 0; --i) {
+            std::construct_at(to + i - 1, std::move(from[i - 1]));
+            std::destroy_at(from + i - 1);
+        }
+    }
+}
+
+template <typename T>
+void GapVector<T>::MoveGap(size_t pos) noexcept {
+    if (pos < gap_begin_) {
+        size_t count = gap_begin_ - pos;
+        RelocateOverlapping(data_ + pos, count, data_ + gap_end_ - count);
+        gap_begin_ -= count;
+        gap_end_ -= count;
+    } else if (pos > gap_begin_) {
+        size_t count = pos - gap_begin_;
+        RelocateOverlapping(data_ + gap_end_, count, data_ + gap_begin_);
+        gap_begin_ += count;
+        gap_end_ += count;
+    }
+}
+
+template <typename T>
+void GapVector<T>::Reallocate(size_t new_cap) {
+    T* new_data = AllocTraits::allocate(alloc_, new_cap);
+    size_t suffix = capacity_ - gap_end_;
+    RelocateOverlapping(data_, gap_begin_, new_data);
+    RelocateOverlapping(data_ + gap_end_, suffix, new_data + new_cap - suffix);
+    if (data_) {
+        AllocTraits::deallocate(alloc_, data_, capacity_);
+    }
+    data_ = new_data;
+    gap_end_ = new_cap - suffix;
+    capacity_ = new_cap;
+}
+
+template <typename T>
+void GapVector<T>::GrowIfFull() {
+    if (gap_begin_ == gap_end_) {
+        Reallocate(std::max(GrowthPolicy::NextCapacity(capacity_, capacity_ + 1), InitialCapacity));
+    }
+}
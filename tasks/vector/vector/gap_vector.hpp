@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+
+#include "vector.hpp"
+
+// GapVector<T> keeps its free capacity as a gap inside the buffer, right
+// after the last edit point (a gap buffer, as used by text editors):
+//
+//     [ elements before the gap | gap | elements after the gap ]
+//
+// Insert and Erase first move the gap to the edit position, shifting only the
+// elements between the old and the new position, so edits clustered around one
+// place are amortized O(1). Indexing stays O(1): positions past the gap are
+// shifted by its size. Moving the gap relocates elements, so T must be nothrow
+// move constructible.
+template <typename T>
+class GapVector {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "moving the gap must not throw");
+
+public:
+    GapVector();
+
+    GapVector(size_t count, const T& value);
+
+    GapVector(std::initializer_list<T> init);
+
+    GapVector(const GapVector& other);
+
+    GapVector& operator=(const GapVector& other);
+
+    GapVector(GapVector&& other) noexcept;
+
+    GapVector& operator=(GapVector&& other) noexcept;
+
+    T& operator[](size_t pos) noexcept;
+
+    const T& operator[](size_t pos) const noexcept;
+
+    T& Front() noexcept;
+
+    T& Back() noexcept;
+
+    bool IsEmpty() const noexcept;
+
+    size_t Size() const noexcept;
+
+    size_t Capacity() const noexcept;
+
+    // Position of the gap, i.e. of the last edit
+    size_t GapPosition() const noexcept;
+
+    void Reserve(size_t new_cap);
+
+    void Clear() noexcept;
+
+    void Insert(size_t pos, T value);
+
+    void Erase(size_t begin_pos, size_t end_pos);
+
+    void PushBack(T value);
+
+    template <class... Args>
+    void EmplaceBack(Args&&... args);
+
+    void PopBack();
+
+    void Swap(GapVector& other) noexcept;
+
+    ~GapVector();
+
+private:
+    using AllocTraits = std::allocator_traits<std::allocator<T>>;
+
+    static constexpr size_t InitialCapacity = 10;
+
+    using GrowthPolicy = DoublingGrowth;
+
+    size_t GapSize() const noexcept;
+
+    // Moves count elements from `from` to uninitialized `to`; the ranges may overlap
+    static void RelocateOverlapping(T* from, size_t count, T* to) noexcept;
+
+    // Shifts elements so that the gap starts at pos
+    void MoveGap(size_t pos) noexcept;
+
+    // Allocates a buffer of new_cap elements, keeping the gap at the same position
+    void Reallocate(size_t new_cap);
+
+    // Makes room for one more element in the gap
+    void GrowIfFull();
+
+    T* data_;
+    size_t gap_begin_;
+    size_t gap_end_;
+    size_t capacity_;
+    std::allocator<T> alloc_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename T>
+void swap(GapVector<T>& a, GapVector<T>& b) {
+    a.Swap(b);
+}
+}  // namespace std
@@ -0,0 +1,316 @@
+#include "mmap_vector.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace detail {
+
+[[noreturn]] inline void ThrowMmapVectorError(const std::string& what, const std::string& path = "") {
+    std::string message = path.empty() ? what : what + " '" + path + "'";
+    throw MmapVectorException(message + ": " + std::strerror(errno));
+}
+
+inline void* MapFile(int fd, size_t bytes, bool read_only) {
+    int prot = read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* ptr = mmap(nullptr, bytes, prot, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        ThrowMmapVectorError("mmap failed");
+    }
+    return ptr;
+}
+
+inline void* RemapFile(void* ptr, int fd, size_t old_bytes, size_t new_bytes) {
+#if defined(__linux__)
+    (void)fd;
+    void* new_ptr = mremap(ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+    if (new_ptr == MAP_FAILED) {
+        ThrowMmapVectorError("mremap failed");
+    }
+    return new_ptr;
+#else
+    // Map the grown file first so the old mapping survives a failure
+    void* new_ptr = MapFile(fd, new_bytes, false);
+    munmap(ptr, old_bytes);
+    return new_ptr;
+#endif
+}
+
+}  // namespace detail
+
+template <typename T>
+MmapVector<T>::MmapVector(const std::string& path, OpenMode mode)
+    : fd_(-1), read_only_(mode == OpenMode::ReadOnly), header_(nullptr), capacity_(0) {
+    fd_ = read_only_ ? open(path.c_str(), O_RDONLY | O_CLOEXEC) : open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        detail::ThrowMmapVectorError("cannot open", path);
+    }
+    try {
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            detail::ThrowMmapVectorError("cannot stat", path);
+        }
+        size_t file_bytes = st.st_size;
+        bool is_new = file_bytes == 0 && !read_only_;
+        if (is_new) {
+            file_bytes = FileBytes(0);
+            if (ftruncate(fd_, file_bytes) != 0) {
+                detail::ThrowMmapVectorError("cannot resize", path);
+            }
+        }
+        if (file_bytes < sizeof(FileHeader)) {
+            throw MmapVectorException("'" + path + "' is not an MmapVector file");
+        }
+        header_ = static_cast<FileHeader*>(detail::MapFile(fd_, file_bytes, read_only_));
+        capacity_ = (file_bytes - sizeof(FileHeader)) / sizeof(T);
+        if (is_new) {
+            header_->magic = Magic;
+            header_->element_size = sizeof(T);
+            header_->size = 0;
+        } else if (header_->magic != Magic || header_->element_size != sizeof(T) || header_->size > capacity_) {
+            throw MmapVectorException("'" + path + "' is not an MmapVector file of this element type");
+        }
+    } catch (...) {
+        Close();
+        throw;
+    }
+}
+
+template <typename T>
+MmapVector<T>::MmapVector(MmapVector&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      read_only_(other.read_only_),
+      header_(std::exchange(other.header_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)) {
+}
+
+template <typename T>
+auto MmapVector<T>::operator=(MmapVector&& other) noexcept -> MmapVector& {
+    if (this != &other) {
+        Close();
+        Swap(other);
+    }
+    return *this;
+}
+
+template <typename T>
+T& MmapVector<T>::operator[](size_t pos) {
+    return Elements()[pos];
+}
+
+template <typename T>
+T& MmapVector<T>::Front() const noexcept {
+    return Elements()[0];
+}
+
+template <typename T>
+T& MmapVector<T>::Back() const noexcept {
+    return Elements()[Size() - 1];
+}
+
+template <typename T>
+T* MmapVector<T>::Data() const noexcept {
+    return header_ ? Elements() : nullptr;
+}
+
+template <typename T>
+bool MmapVector<T>::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+template <typename T>
+size_t MmapVector<T>::Size() const noexcept {
+    return header_ ? header_->size : 0;
+}
+
+template <typename T>
+size_t MmapVector<T>::Capacity() const noexcept {
+    return capacity_;
+}
+
+template <typename T>
+bool MmapVector<T>::IsReadOnly() const noexcept {
+    return read_only_;
+}
+
+template <typename T>
+void MmapVector<T>::Reserve(size_t new_cap) {
+    if (new_cap > capacity_) {
+        CheckWritable();
+        Grow(new_cap);
+    }
+}
+
+template <typename T>
+void MmapVector<T>::Clear() {
+    CheckWritable();
+    header_->size = 0;
+}
+
+template <typename T>
+void MmapVector<T>::Insert(size_t pos, T value) {
+    CheckWritable();
+    size_t size = Size();
+    pos = std::min(pos, size);
+    Reserve(NextCapacity(size + 1));
+    T* data = Elements();
+    std::memmove(static_cast<void*>(data + pos + 1), data + pos, (size - pos) * sizeof(T));
+    std::memcpy(static_cast<void*>(data + pos), &value, sizeof(T));
+    header_->size = size + 1;
+}
+
+template <typename T>
+void MmapVector<T>::Erase(size_t begin_pos, size_t end_pos) {
+    CheckWritable();
+    size_t size = Size();
+    end_pos = std::min(end_pos, size);
+    if (begin_pos >= end_pos) {
+        return;
+    }
+    T* data = Elements();
+    std::memmove(static_cast<void*>(data + begin_pos), data + end_pos, (size - end_pos) * sizeof(T));
+    header_->size = size - (end_pos - begin_pos);
+}
+
+template <typename T>
+void MmapVector<T>::PushBack(T value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T>
+template <class... Args>
+void MmapVector<T>::EmplaceBack(Args&&... args) {
+    CheckWritable();
+    // Growing may move the mapping args point into: build the element first
+    T value(std::forward<Args>(args)...);
+    size_t size = Size();
+    Reserve(NextCapacity(size + 1));
+    std::memcpy(static_cast<void*>(Elements() + size), &value, sizeof(T));
+    header_->size = size + 1;
+}
+
+template <typename T>
+void MmapVector<T>::PopBack() {
+    CheckWritable();
+    --header_->size;
+}
+
+template <typename T>
+void MmapVector<T>::Resize(size_t count, const T& value) {
+    CheckWritable();
+    size_t size = Size();
+    if (count > size) {
+        // value may live in our own mapping
+        T fill = value;
+        Reserve(count);
+        std::fill(Elements() + size, Elements() + count, fill);
+    }
+    header_->size = count;
+}
+
+template <typename T>
+void MmapVector<T>::Flush() {
+    if (header_ && msync(header_, FileBytes(capacity_), MS_SYNC) != 0) {
+        detail::ThrowMmapVectorError("msync failed");
+    }
+}
+
+template <typename T>
+void MmapVector<T>::Advise(AccessPattern pattern) {
+    if (!header_) {
+        return;
+    }
+    int advice = MADV_NORMAL;
+    switch (pattern) {
+        case AccessPattern::Normal:
+            advice = MADV_NORMAL;
+            break;
+        case AccessPattern::Sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case AccessPattern::Random:
+            advice = MADV_RANDOM;
+            break;
+        case AccessPattern::WillNeed:
+            advice = MADV_WILLNEED;
+            break;
+    }
+    if (madvise(header_, FileBytes(capacity_), advice) != 0) {
+        detail::ThrowMmapVectorError("madvise failed");
+    }
+}
+
+template <typename T>
+void MmapVector<T>::Swap(MmapVector& other) noexcept {
+    std::swap(fd_, other.fd_);
+    std::swap(read_only_, other.read_only_);
+    std::swap(header_, other.header_);
+    std::swap(capacity_, other.capacity_);
+}
+
+template <typename T>
+MmapVector<T>::~MmapVector() {
+    Close();
+}
+
+template <typename T>
+size_t MmapVector<T>::FileBytes(size_t capacity) noexcept {
+    return sizeof(FileHeader) + capacity * sizeof(T);
+}
+
+template <typename T>
+size_t MmapVector<T>::NextCapacity(size_t min_cap) const noexcept {
+    if (min_cap <= capacity_) {
+        return capacity_;
+    }
+    return std::max(GrowthPolicy::NextCapacity(capacity_, min_cap), InitialCapacity);
+}
+
+template <typename T>
+T* MmapVector<T>::Elements() const noexcept {
+    return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(header_) + sizeof(FileHeader));
+}
+
+template <typename T>
+void MmapVector<T>::CheckWritable() const {
+    if (read_only_) {
+        throw MmapVectorException("MmapVector is opened read-only");
+    }
+}
+
+template <typename T>
+void MmapVector<T>::Grow(size_t new_cap) {
+    size_t old_bytes = FileBytes(capacity_);
+    size_t new_bytes = FileBytes(new_cap);
+    if (ftruncate(fd_, new_bytes) != 0) {
+        detail::ThrowMmapVectorError("cannot resize the backing file");
+    }
+    try {
+        header_ = static_cast<FileHeader*>(detail::RemapFile(header_, fd_, old_bytes, new_bytes));
+    } catch (...) {
+        // Keep the file consistent with the mapping we still have
+        [[maybe_unused]] int rc = ftruncate(fd_, old_bytes);
+        throw;
+    }
+    capacity_ = new_cap;
+}
+
+template <typename T>
+void MmapVector<T>::Close() noexcept {
+    if (header_) {
+        munmap(header_, FileBytes(capacity_));
+        header_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    capacity_ = 0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+// MmapVector<T> has the API of Vector<T>, but its elements live in a file
+// mapped with MAP_SHARED. The size is stored in the file as well, so a vector
+// persists between runs and reopening it costs a single mmap instead of
+// rebuilding the data. Growth extends the file with ftruncate and remaps it.
+//
+// Elements are stored as raw bytes, so T must be trivially copyable.
+// Failing system calls throw MmapVectorException.
+template <typename T>
+class MmapVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MmapVector stores elements as raw bytes of a file");
+    static_assert(alignof(T) <= 64, "elements are placed right after a 64-byte file header");
+
+public:
+    enum class OpenMode {
+        // Opens the file, creating an empty vector if it does not exist
+        ReadWrite,
+        // Maps an existing file read-only: modifying calls throw,
+        // writes through operator[] or Data() fault
+        ReadOnly,
+    };
+
+    // Hints for the kernel read-ahead, applied to the whole mapping
+    enum class AccessPattern {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed,
+    };
+
+    explicit MmapVector(const std::string& path, OpenMode mode = OpenMode::ReadWrite);
+
+    MmapVector(const MmapVector& other) = delete;
+
+    MmapVector& operator=(const MmapVector& other) = delete;
+
+    MmapVector(MmapVector&& other) noexcept;
+
+    MmapVector& operator=(MmapVector&& other) noexcept;
+
+    T& operator[](size_t pos);
+
+    T& Front() const noexcept;
+
+    T& Back() const noexcept;
+
+    T* Data() const noexcept;
+
+    bool IsEmpty() const noexcept;
+
+    size_t Size() const noexcept;
+
+    size_t Capacity() const noexcept;
+
+    bool IsReadOnly() const noexcept;
+
+    void Reserve(size_t new_cap);
+
+    void Clear();
+
+    void Insert(size_t pos, T value);
+
+    void Erase(size_t begin_pos, size_t end_pos);
+
+    void PushBack(T value);
+
+    template <class... Args>
+    void EmplaceBack(Args&&... args);
+
+    void PopBack();
+
+    void Resize(size_t count, const T& value);
+
+    // Writes dirty pages back to the file and waits for the write to finish
+    void Flush();
+
+    void Advise(AccessPattern pattern);
+
+    void Swap(MmapVector& other) noexcept;
+
+    ~MmapVector();
+
+private:
+    // Placed at the start of the file; elements follow at offset sizeof(FileHeader)
+    struct alignas(64) FileHeader {
+        uint64_t magic;
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    static constexpr uint64_t Magic = 0x3143455650414d4d;  // "MMAPVEC1"
+
+    static constexpr size_t InitialCapacity = 10;
+
+    using GrowthPolicy = DoublingGrowth;
+
+    static size_t FileBytes(size_t capacity) noexcept;
+
+    size_t NextCapacity(size_t min_cap) const noexcept;
+
+    T* Elements() const noexcept;
+
+    void CheckWritable() const;
+
+    // Extends the file to new_cap elements and remaps it
+    void Grow(size_t new_cap);
+
+    void Close() noexcept;
+
+    int fd_;
+    bool read_only_;
+    FileHeader* header_;
+    size_t capacity_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename T>
+void swap(MmapVector<T>& a, MmapVector<T>& b) {
+    a.Swap(b);
+}
+}  // namespace std
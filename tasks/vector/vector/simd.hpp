@@ -0,0 +1,550 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "vector.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Vectorized Find/Count/Min/Max/Sum over arithmetic buffers.
+//
+// int32_t and float have SSE2 and AVX2 kernels picked at runtime; other
+// arithmetic types, and CPUs without SSE2, use the scalar kernels. All levels
+// return bit-identical results: floating point reductions are done in 8 lanes
+// (lane j takes elements i with i % 8 == j), lanes are combined in a fixed
+// tree order and the tail is folded in sequentially, no matter how many lanes
+// the hardware has.
+//
+// Min and Max require a non-empty buffer, like Front().
+namespace simd {
+
+enum class Level { Scalar, Sse2, Avx2 };
+
+// Integers are summed in 64 bits, floating point types in themselves
+template <typename T>
+using SumType =
+    std::conditional_t<std::is_integral_v<T>, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>, T>;
+
+inline Level BestLevel() {
+#if defined(__x86_64__)
+    static const Level level = __builtin_cpu_supports("avx2") ? Level::Avx2 : Level::Sse2;
+    return level;
+#else
+    return Level::Scalar;
+#endif
+}
+
+namespace detail {
+
+inline constexpr size_t Lanes = 8;
+
+// Same semantics as _mm_min_ps(a, b) / _mm_max_ps(a, b), NaN included
+template <typename T>
+T MinOf(T a, T b) {
+    return a < b ? a : b;
+}
+
+template <typename T>
+T MaxOf(T a, T b) {
+    return a > b ? a : b;
+}
+
+template <typename T>
+T PlusOf(T a, T b) {
+    return a + b;
+}
+
+template <typename T, typename Op>
+T CombineLanes(const T* lanes, Op op) {
+    return op(op(op(lanes[0], lanes[1]), op(lanes[2], lanes[3])), op(op(lanes[4], lanes[5]), op(lanes[6], lanes[7])));
+}
+
+template <typename T>
+inline constexpr bool HasKernels = std::is_same_v<T, int32_t> || std::is_same_v<T, float>;
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar reference kernels
+
+template <typename T>
+size_t FindScalar(const T* data, size_t size, T value) {
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <typename T>
+size_t CountScalar(const T* data, size_t size, T value) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+// Lane-wise fold of op over the buffer in the canonical 8-lane order
+template <typename T, typename Op>
+T ReduceScalar(const T* data, size_t size, Op op) {
+    if (size < Lanes) {
+        T result = data[0];
+        for (size_t i = 1; i < size; ++i) {
+            result = op(result, data[i]);
+        }
+        return result;
+    }
+    T lanes[Lanes];
+    for (size_t j = 0; j < Lanes; ++j) {
+        lanes[j] = data[j];
+    }
+    size_t i = Lanes;
+    for (; i + Lanes <= size; i += Lanes) {
+        for (size_t j = 0; j < Lanes; ++j) {
+            lanes[j] = op(lanes[j], data[i + j]);
+        }
+    }
+    T result = CombineLanes(lanes, op);
+    for (; i < size; ++i) {
+        result = op(result, data[i]);
+    }
+    return result;
+}
+
+template <typename T>
+SumType<T> SumScalar(const T* data, size_t size) {
+    SumType<T> lanes[Lanes] = {};
+    size_t i = 0;
+    for (; i + Lanes <= size; i += Lanes) {
+        for (size_t j = 0; j < Lanes; ++j) {
+            lanes[j] += data[i + j];
+        }
+    }
+    SumType<T> result = CombineLanes(lanes, PlusOf<SumType<T>>);
+    for (; i < size; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+#if defined(__x86_64__)
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels: two 4-wide registers make up the 8 canonical lanes
+
+inline __m128i Equal(__m128i a, __m128i b) {
+    return _mm_cmpeq_epi32(a, b);
+}
+
+inline __m128i Equal(__m128 a, __m128 b) {
+    return _mm_castps_si128(_mm_cmpeq_ps(a, b));
+}
+
+template <typename T>
+auto Load4(const T* ptr) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_loadu_ps(ptr);
+    } else {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    }
+}
+
+template <typename T>
+auto Splat4(T value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_set1_ps(value);
+    } else {
+        return _mm_set1_epi32(value);
+    }
+}
+
+template <typename T>
+size_t FindSse2(const T* data, size_t size, T value) {
+    auto needle = Splat4(value);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(Equal(Load4(data + i), needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    size_t tail = FindScalar(data + i, size - i, value);
+    return i + tail;
+}
+
+template <typename T>
+size_t CountSse2(const T* data, size_t size, T value) {
+    // Per-lane 32-bit counters are flushed often enough to never overflow
+    constexpr size_t Block = size_t{1} << 20;
+    auto needle = Splat4(value);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 4 <= size) {
+        __m128i counters = _mm_setzero_si128();
+        size_t block_end = std::min(size, i + Block);
+        for (; i + 4 <= block_end; i += 4) {
+            counters = _mm_sub_epi32(counters, Equal(Load4(data + i), needle));
+        }
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), counters);
+        count += size_t{lanes[0]} + lanes[1] + lanes[2] + lanes[3];
+    }
+    return count + CountScalar(data + i, size - i, value);
+}
+
+inline __m128i MinSse2(__m128i a, __m128i b) {
+    __m128i a_less = _mm_cmplt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(a_less, a), _mm_andnot_si128(a_less, b));
+}
+
+inline __m128i MaxSse2(__m128i a, __m128i b) {
+    __m128i a_greater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(a_greater, a), _mm_andnot_si128(a_greater, b));
+}
+
+inline __m128 MinSse2(__m128 a, __m128 b) {
+    return _mm_min_ps(a, b);
+}
+
+inline __m128 MaxSse2(__m128 a, __m128 b) {
+    return _mm_max_ps(a, b);
+}
+
+template <typename T>
+void Store4(T* ptr, __m128i value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), value);
+}
+
+template <typename T>
+void Store4(T* ptr, __m128 value) {
+    _mm_storeu_ps(ptr, value);
+}
+
+template <bool IsMin, typename T>
+T MinMaxSse2(const T* data, size_t size) {
+    auto op = [](auto a, auto b) {
+        if constexpr (IsMin) {
+            return MinSse2(a, b);
+        } else {
+            return MaxSse2(a, b);
+        }
+    };
+    auto scalar_op = IsMin ? MinOf<T> : MaxOf<T>;
+    if (size < Lanes) {
+        return ReduceScalar(data, size, scalar_op);
+    }
+    auto low = Load4(data);
+    auto high = Load4(data + 4);
+    size_t i = Lanes;
+    for (; i + Lanes <= size; i += Lanes) {
+        low = op(low, Load4(data + i));
+        high = op(high, Load4(data + i + 4));
+    }
+    T lanes[Lanes];
+    Store4(lanes, low);
+    Store4(lanes + 4, high);
+    T result = CombineLanes(lanes, scalar_op);
+    for (; i < size; ++i) {
+        result = scalar_op(result, data[i]);
+    }
+    return result;
+}
+
+inline int64_t SumSse2(const int32_t* data, size_t size) {
+    __m128i sums = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i values = Load4(data + i);
+        __m128i signs = _mm_srai_epi32(values, 31);
+        sums = _mm_add_epi64(sums, _mm_unpacklo_epi32(values, signs));
+        sums = _mm_add_epi64(sums, _mm_unpackhi_epi32(values, signs));
+    }
+    alignas(16) int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sums);
+    return lanes[0] + lanes[1] + SumScalar(data + i, size - i);
+}
+
+inline float SumSse2(const float* data, size_t size) {
+    __m128 low = _mm_setzero_ps();
+    __m128 high = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + Lanes <= size; i += Lanes) {
+        low = _mm_add_ps(low, _mm_loadu_ps(data + i));
+        high = _mm_add_ps(high, _mm_loadu_ps(data + i + 4));
+    }
+    float lanes[Lanes];
+    _mm_storeu_ps(lanes, low);
+    _mm_storeu_ps(lanes + 4, high);
+    float result = CombineLanes(lanes, PlusOf<float>);
+    for (; i < size; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels: one 8-wide register is exactly the canonical lanes
+
+#define SIMD_AVX2 __attribute__((target("avx2")))
+
+SIMD_AVX2 inline __m256i Equal(__m256i a, __m256i b) {
+    return _mm256_cmpeq_epi32(a, b);
+}
+
+SIMD_AVX2 inline __m256i Equal(__m256 a, __m256 b) {
+    return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+}
+
+template <typename T>
+SIMD_AVX2 auto Load8(const T* ptr) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_loadu_ps(ptr);
+    } else {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+}
+
+template <typename T>
+SIMD_AVX2 auto Splat8(T value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_set1_ps(value);
+    } else {
+        return _mm256_set1_epi32(value);
+    }
+}
+
+template <typename T>
+SIMD_AVX2 size_t FindAvx2(const T* data, size_t size, T value) {
+    auto needle = Splat8(value);
+    size_t i = 0;
+    for (; i + Lanes <= size; i += Lanes) {
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(Equal(Load8(data + i), needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    size_t tail = FindScalar(data + i, size - i, value);
+    return i + tail;
+}
+
+template <typename T>
+SIMD_AVX2 size_t CountAvx2(const T* data, size_t size, T value) {
+    constexpr size_t Block = size_t{1} << 20;
+    auto needle = Splat8(value);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + Lanes <= size) {
+        __m256i counters = _mm256_setzero_si256();
+        size_t block_end = std::min(size, i + Block);
+        for (; i + Lanes <= block_end; i += Lanes) {
+            counters = _mm256_sub_epi32(counters, Equal(Load8(data + i), needle));
+        }
+        alignas(32) uint32_t lanes[Lanes];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counters);
+        for (uint32_t lane : lanes) {
+            count += lane;
+        }
+    }
+    return count + CountScalar(data + i, size - i, value);
+}
+
+SIMD_AVX2 inline __m256i MinAvx2(__m256i a, __m256i b) {
+    return _mm256_min_epi32(a, b);
+}
+
+SIMD_AVX2 inline __m256i MaxAvx2(__m256i a, __m256i b) {
+    return _mm256_max_epi32(a, b);
+}
+
+SIMD_AVX2 inline __m256 MinAvx2(__m256 a, __m256 b) {
+    return _mm256_min_ps(a, b);
+}
+
+SIMD_AVX2 inline __m256 MaxAvx2(__m256 a, __m256 b) {
+    return _mm256_max_ps(a, b);
+}
+
+template <typename T>
+SIMD_AVX2 void Store8(T* ptr, __m256i value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), value);
+}
+
+template <typename T>
+SIMD_AVX2 void Store8(T* ptr, __m256 value) {
+    _mm256_storeu_ps(ptr, value);
+}
+
+template <bool IsMin, typename T>
+SIMD_AVX2 T MinMaxAvx2(const T* data, size_t size) {
+    auto scalar_op = IsMin ? MinOf<T> : MaxOf<T>;
+    if (size < Lanes) {
+        return ReduceScalar(data, size, scalar_op);
+    }
+    auto acc = Load8(data);
+    size_t i = Lanes;
+    for (; i + Lanes <= size; i += Lanes) {
+        if constexpr (IsMin) {
+            acc = MinAvx2(acc, Load8(data + i));
+        } else {
+            acc = MaxAvx2(acc, Load8(data + i));
+        }
+    }
+    T lanes[Lanes];
+    Store8(lanes, acc);
+    T result = CombineLanes(lanes, scalar_op);
+    for (; i < size; ++i) {
+        result = scalar_op(result, data[i]);
+    }
+    return result;
+}
+
+SIMD_AVX2 inline int64_t SumAvx2(const int32_t* data, size_t size) {
+    __m256i sums = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + Lanes <= size; i += Lanes) {
+        __m256i values = Load8(data + i);
+        sums = _mm256_add_epi64(sums, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+        sums = _mm256_add_epi64(sums, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumScalar(data + i, size - i);
+}
+
+SIMD_AVX2 inline float SumAvx2(const float* data, size_t size) {
+    __m256 sums = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + Lanes <= size; i += Lanes) {
+        sums = _mm256_add_ps(sums, _mm256_loadu_ps(data + i));
+    }
+    float lanes[Lanes];
+    _mm256_storeu_ps(lanes, sums);
+    float result = CombineLanes(lanes, PlusOf<float>);
+    for (; i < size; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+#undef SIMD_AVX2
+
+#endif  // __x86_64__
+
+}  // namespace detail
+
+// Index of the first element equal to value, or size if there is none
+template <typename T>
+size_t Find(const T* data, size_t size, T value, Level level = BestLevel()) {
+#if defined(__x86_64__)
+    if constexpr (detail::HasKernels<T>) {
+        if (level == Level::Avx2) {
+            return detail::FindAvx2(data, size, value);
+        }
+        if (level == Level::Sse2) {
+            return detail::FindSse2(data, size, value);
+        }
+    }
+#endif
+    (void)level;
+    return detail::FindScalar(data, size, value);
+}
+
+template <typename T>
+size_t Count(const T* data, size_t size, T value, Level level = BestLevel()) {
+#if defined(__x86_64__)
+    if constexpr (detail::HasKernels<T>) {
+        if (level == Level::Avx2) {
+            return detail::CountAvx2(data, size, value);
+        }
+        if (level == Level::Sse2) {
+            return detail::CountSse2(data, size, value);
+        }
+    }
+#endif
+    (void)level;
+    return detail::CountScalar(data, size, value);
+}
+
+template <typename T>
+T Min(const T* data, size_t size, Level level = BestLevel()) {
+#if defined(__x86_64__)
+    if constexpr (detail::HasKernels<T>) {
+        if (level == Level::Avx2) {
+            return detail::MinMaxAvx2<true>(data, size);
+        }
+        if (level == Level::Sse2) {
+            return detail::MinMaxSse2<true>(data, size);
+        }
+    }
+#endif
+    (void)level;
+    return detail::ReduceScalar(data, size, detail::MinOf<T>);
+}
+
+template <typename T>
+T Max(const T* data, size_t size, Level level = BestLevel()) {
+#if defined(__x86_64__)
+    if constexpr (detail::HasKernels<T>) {
+        if (level == Level::Avx2) {
+            return detail::MinMaxAvx2<false>(data, size);
+        }
+        if (level == Level::Sse2) {
+            return detail::MinMaxSse2<false>(data, size);
+        }
+    }
+#endif
+    (void)level;
+    return detail::ReduceScalar(data, size, detail::MaxOf<T>);
+}
+
+template <typename T>
+SumType<T> Sum(const T* data, size_t size, Level level = BestLevel()) {
+#if defined(__x86_64__)
+    if constexpr (detail::HasKernels<T>) {
+        if (level == Level::Avx2) {
+            return detail::SumAvx2(data, size);
+        }
+        if (level == Level::Sse2) {
+            return detail::SumSse2(data, size);
+        }
+    }
+#endif
+    (void)level;
+    return detail::SumScalar(data, size);
+}
+
+// Vector overloads
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t N>
+size_t Find(const Vector<T, Allocator, GrowthPolicy, N>& vec, std::type_identity_t<T> value,
+            Level level = BestLevel()) {
+    return Find(vec.Data(), vec.Size(), value, level);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t N>
+size_t Count(const Vector<T, Allocator, GrowthPolicy, N>& vec, std::type_identity_t<T> value,
+             Level level = BestLevel()) {
+    return Count(vec.Data(), vec.Size(), value, level);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t N>
+T Min(const Vector<T, Allocator, GrowthPolicy, N>& vec, Level level = BestLevel()) {
+    return Min(vec.Data(), vec.Size(), level);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t N>
+T Max(const Vector<T, Allocator, GrowthPolicy, N>& vec, Level level = BestLevel()) {
+    return Max(vec.Data(), vec.Size(), level);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t N>
+SumType<T> Sum(const Vector<T, Allocator, GrowthPolicy, N>& vec, Level level = BestLevel()) {
+    return Sum(vec.Data(), vec.Size(), level);
+}
+
+}  // namespace simd
@@ -0,0 +1,101 @@
+#include "soa_vector.hpp"
+
+#include <algorithm>
+
+template <typename... Ts>
+std::tuple<Ts&...> SoaVector<Ts...>::operator[](size_t pos) {
+    return std::apply([pos](Vector<Ts>&... columns) { return std::tuple<Ts&...>(columns[pos]...); }, columns_);
+}
+
+template <typename... Ts>
+template <size_t I>
+std::span<typename SoaVector<Ts...>::template FieldType<I>> SoaVector<Ts...>::Span() {
+    auto& column = std::get<I>(columns_);
+    return {column.Data(), column.Size()};
+}
+
+template <typename... Ts>
+template <size_t I>
+std::span<const typename SoaVector<Ts...>::template FieldType<I>> SoaVector<Ts...>::Span() const {
+    auto& column = std::get<I>(columns_);
+    return {column.Data(), column.Size()};
+}
+
+template <typename... Ts>
+auto SoaVector<Ts...>::Begin() -> ZipIterator {
+    return ZipIterator(ColumnData(), 0);
+}
+
+template <typename... Ts>
+auto SoaVector<Ts...>::End() -> ZipIterator {
+    return ZipIterator(ColumnData(), Size());
+}
+
+template <typename... Ts>
+bool SoaVector<Ts...>::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+template <typename... Ts>
+size_t SoaVector<Ts...>::Size() const noexcept {
+    return std::get<0>(columns_).Size();
+}
+
+template <typename... Ts>
+size_t SoaVector<Ts...>::Capacity() const noexcept {
+    // Equal unless a Reserve failed half way
+    return std::apply([](const Vector<Ts>&... columns) { return std::min({columns.Capacity()...}); }, columns_);
+}
+
+template <typename... Ts>
+void SoaVector<Ts...>::Reserve(size_t new_cap) {
+    std::apply([new_cap](Vector<Ts>&... columns) { (columns.Reserve(new_cap), ...); }, columns_);
+}
+
+template <typename... Ts>
+void SoaVector<Ts...>::Clear() noexcept {
+    std::apply([](Vector<Ts>&... columns) { (columns.Clear(), ...); }, columns_);
+}
+
+template <typename... Ts>
+void SoaVector<Ts...>::PushBack(Ts... values) {
+    size_t capacity = Capacity();
+    if (Size() == capacity) {
+        Reserve(std::max(GrowthPolicy::NextCapacity(capacity, capacity + 1), InitialCapacity));
+    }
+    PushColumns(std::index_sequence_for<Ts...>{}, std::move(values)...);
+}
+
+template <typename... Ts>
+void SoaVector<Ts...>::PopBack() {
+    std::apply([](Vector<Ts>&... columns) { (columns.PopBack(), ...); }, columns_);
+}
+
+template <typename... Ts>
+void SoaVector<Ts...>::Swap(SoaVector& other) {
+    columns_.swap(other.columns_);
+}
+
+template <typename... Ts>
+std::tuple<Ts*...> SoaVector<Ts...>::ColumnData() {
+    return std::apply([](Vector<Ts>&... columns) { return std::tuple<Ts*...>(columns.Data()...); }, columns_);
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void SoaVector<Ts...>::PushColumns(std::index_sequence<Is...>, Ts&&... values) {
+    // Capacity is reserved: only constructing a field can throw
+    size_t pushed = 0;
+    try {
+        ((std::get<Is>(columns_).EmplaceBack(std::move(values)), ++pushed), ...);
+    } catch (...) {
+        PopColumns(std::index_sequence<Is...>{}, pushed);
+        throw;
+    }
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void SoaVector<Ts...>::PopColumns(std::index_sequence<Is...>, size_t count) {
+    ((Is < count ? std::get<Is>(columns_).PopBack() : void()), ...);
+}
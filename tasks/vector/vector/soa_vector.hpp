@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#include "vector.hpp"
+
+// SoaVector<Ts...> stores records of fields Ts... as a struct of arrays: one
+// Vector per field, all of the same size and capacity. A scan over one field
+// reads only that field's column instead of every whole record.
+//
+// Columns are reserved together, so appending a record never reallocates one
+// column on its own; if constructing a field throws, the fields already
+// appended for that record are removed again.
+template <typename... Ts>
+class SoaVector {
+    static_assert(sizeof...(Ts) > 0, "a record needs at least one field");
+
+public:
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    // Random access iterator over whole records; dereferencing gives a tuple of references to the fields
+    class ZipIterator {
+    public:
+        using value_type = std::tuple<Ts...>;
+        using reference = std::tuple<Ts&...>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+
+        ZipIterator() = default;
+
+        reference operator*() const {
+            return std::apply([this](Ts*... columns) { return reference(columns[pos_]...); }, columns_);
+        }
+
+        reference operator[](difference_type offset) const {
+            return *(*this + offset);
+        }
+
+        ZipIterator& operator++() {
+            ++pos_;
+            return *this;
+        }
+
+        ZipIterator operator++(int) {
+            ZipIterator old = *this;
+            ++pos_;
+            return old;
+        }
+
+        ZipIterator& operator--() {
+            --pos_;
+            return *this;
+        }
+
+        ZipIterator operator--(int) {
+            ZipIterator old = *this;
+            --pos_;
+            return old;
+        }
+
+        ZipIterator& operator+=(difference_type offset) {
+            pos_ += offset;
+            return *this;
+        }
+
+        ZipIterator& operator-=(difference_type offset) {
+            pos_ -= offset;
+            return *this;
+        }
+
+        friend ZipIterator operator+(ZipIterator it, difference_type offset) {
+            return it += offset;
+        }
+
+        friend ZipIterator operator+(difference_type offset, ZipIterator it) {
+            return it += offset;
+        }
+
+        friend ZipIterator operator-(ZipIterator it, difference_type offset) {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const ZipIterator& a, const ZipIterator& b) {
+            return static_cast<difference_type>(a.pos_) - static_cast<difference_type>(b.pos_);
+        }
+
+        friend bool operator==(const ZipIterator& a, const ZipIterator& b) {
+            return a.pos_ == b.pos_;
+        }
+
+        friend auto operator<=>(const ZipIterator& a, const ZipIterator& b) {
+            return a.pos_ <=> b.pos_;
+        }
+
+    private:
+        friend class SoaVector;
+
+        ZipIterator(std::tuple<Ts*...> columns, size_t pos) : columns_(columns), pos_(pos) {
+        }
+
+        std::tuple<Ts*...> columns_;
+        size_t pos_ = 0;
+    };
+
+    SoaVector() = default;
+
+    // Tuple of references to the fields of record pos
+    std::tuple<Ts&...> operator[](size_t pos);
+
+    // Contiguous view of column I
+    template <size_t I>
+    std::span<FieldType<I>> Span();
+
+    template <size_t I>
+    std::span<const FieldType<I>> Span() const;
+
+    ZipIterator Begin();
+
+    ZipIterator End();
+
+    bool IsEmpty() const noexcept;
+
+    size_t Size() const noexcept;
+
+    size_t Capacity() const noexcept;
+
+    void Reserve(size_t new_cap);
+
+    void Clear() noexcept;
+
+    void PushBack(Ts... values);
+
+    void PopBack();
+
+    void Swap(SoaVector& other);
+
+private:
+    static constexpr size_t InitialCapacity = 10;
+
+    using GrowthPolicy = DoublingGrowth;
+
+    std::tuple<Ts*...> ColumnData();
+
+    template <size_t... Is>
+    void PushColumns(std::index_sequence<Is...>, Ts&&... values);
+
+    // Removes the last element of the first `count` columns
+    template <size_t... Is>
+    void PopColumns(std::index_sequence<Is...>, size_t count);
+
+    std::tuple<Vector<Ts>...> columns_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename... Ts>
+void swap(SoaVector<Ts...>& a, SoaVector<Ts...>& b) {
+    a.Swap(b);
+}
+}  // namespace std
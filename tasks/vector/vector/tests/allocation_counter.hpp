@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+// Replaces the global operator new, so the benchmarks can count how often a
+// workload reaches the heap. Include it from exactly one file per binary.
+//
+// mimalloc is linked into every binary and overrides malloc and free, so the
+// replacement calls glibc directly: containers with std::allocator then run
+// on the glibc heap, and mimalloc is measured only where it is asked for.
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+inline std::atomic<size_t> allocation_count{0};
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = __libc_malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  __libc_free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  __libc_free(ptr);
+}
+
+// Pool slabs are over-aligned, so count these as well
+void* operator new(size_t size, std::align_val_t alignment) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = __libc_memalign(static_cast<size_t>(alignment), size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  __libc_free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+  __libc_free(ptr);
+}
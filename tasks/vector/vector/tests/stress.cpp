@@ -1,14 +1,45 @@
 #include "../vector.hpp"
 #include "../vector.cpp"
+#include "../simd.hpp"
+#include "../mmap_vector.hpp"
+#include "../mmap_vector.cpp"
+#include "../concurrent_vector.hpp"
+#include "../concurrent_vector.cpp"
+#include "../gap_vector.hpp"
+#include "../gap_vector.cpp"
+#include "../soa_vector.hpp"
+#include "../soa_vector.cpp"
+#include "../vector_io.hpp"
+#include "../vector_io.cpp"
+#include "../cow_vector.hpp"
+#include "../cow_vector.cpp"
+#include "allocation_counter.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
 #include <random>
 #include <vector>
 #include <string>
+#include <thread>
 
 #include <benchmark/benchmark.h>
+#include <fcntl.h>
 #include <fmt/core.h>
+#include <mimalloc.h>
+#include <unistd.h>
 
-void ConstructRandomVector(Vector<int>& vec, int sz) {
+template <typename Vec>
+void ConstructRandomVector(Vec& vec, int sz) {
   std::random_device rd;
   std::mt19937 mt(rd());
   std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
@@ -49,12 +80,51 @@ void BM_StdVectorPushBack(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// Owning handle: not trivially copyable, yet moving its bytes is a valid move
+template <bool Relocatable>
+class Handle {
+public:
+  explicit Handle(int value) : value_(std::make_unique<int>(value)) {
+  }
+
+  Handle(Handle&&) noexcept = default;
+
+  Handle& operator=(Handle&&) noexcept = default;
+
+private:
+  std::unique_ptr<int> value_;
+};
+
+template <>
+struct IsTriviallyRelocatable<Handle<true>> : std::true_type {};
+
+using RelocatableHandle = Handle<true>;
+using PlainHandle = Handle<false>;
+
+template <typename T>
 void BM_CustomVectorMiddleInsert(benchmark::State& state) {
-  Vector<int> vec;
-  ConstructRandomVector(vec, 100);
+  Vector<T> vec;
+  for (int i = 0; i < 100; ++i) {
+    vec.PushBack(T(i));
+  }
   for (auto _ : state) {
     for (int i = 0; i < state.range(0); ++i){
-      vec.Insert(vec.Size() / 2, 50);
+      vec.Insert(vec.Size() / 2, T(50));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// The BM_CustomVectorMiddleInsert pattern: the gap follows the insertion point
+template <typename T>
+void BM_GapVectorMiddleInsert(benchmark::State& state) {
+  GapVector<T> vec;
+  for (int i = 0; i < 100; ++i) {
+    vec.PushBack(T(i));
+  }
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i){
+      vec.Insert(vec.Size() / 2, T(50));
     }
   }
   state.SetComplexityN(state.range(0));
@@ -74,10 +144,817 @@ void BM_StdVectorMiddleInsert(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// Fresh vector per iteration: shows the allocations paid below and above the inline capacity
+template <typename Vec>
+void BM_SmallVectorPushBack(benchmark::State& state) {
+  size_t allocations = 0;
+  for (auto _ : state) {
+    size_t before = allocation_count;
+    Vec vec;
+    for (int i = 0; i < state.range(0); ++i) {
+      vec.PushBack(i);
+    }
+    benchmark::DoNotOptimize(vec.Data());
+    allocations += allocation_count - before;
+  }
+  int64_t pushes = state.iterations() * state.range(0);
+  state.counters["allocs"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+  state.counters["push_latency"] = benchmark::Counter(pushes, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+void BM_StdVectorSmallPushBack(benchmark::State& state) {
+  size_t allocations = 0;
+  for (auto _ : state) {
+    size_t before = allocation_count;
+    std::vector<int> vec;
+    for (int i = 0; i < state.range(0); ++i) {
+      vec.push_back(i);
+    }
+    benchmark::DoNotOptimize(vec.data());
+    allocations += allocation_count - before;
+  }
+  int64_t pushes = state.iterations() * state.range(0);
+  state.counters["allocs"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+  state.counters["push_latency"] = benchmark::Counter(pushes, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// The BM_CustomVectorPushBack workload on a fresh vector per iteration, so every
+// allocator sees the same growth sequence
+template <typename Allocator>
+void BM_CustomVectorPushBackWithAllocator(benchmark::State& state) {
+  for (auto _ : state) {
+    Vector<int, Allocator> vec;
+    ConstructRandomVector(vec, state.range(0));
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomVectorPushBackArena(benchmark::State& state) {
+  for (auto _ : state) {
+    // Released all at once when the resource goes out of scope
+    std::pmr::monotonic_buffer_resource arena;
+    Vector<int, std::pmr::polymorphic_allocator<int>> vec(&arena);
+    ConstructRandomVector(vec, state.range(0));
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Resets VmHWM (peak RSS) of the process to its current RSS
+void ResetPeakRss() {
+  std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+// Reads a "<field>: <value> kB" line of /proc/self/status (or another /proc file), in bytes
+int64_t ReadStatusBytes(const std::string& field, const std::string& file = "/proc/self/status") {
+  std::ifstream status(file);
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind(field, 0) == 0) {
+      return std::stoll(line.substr(field.size())) * 1024;
+    }
+  }
+  return 0;
+}
+
+// Peak RSS over the iteration and bytes moved by reallocations for each growth policy
+template <typename GrowthPolicy>
+void BM_VectorGrowthPolicy(benchmark::State& state) {
+  int64_t bytes_copied = 0;
+  int64_t peak_rss = 0;
+  int64_t capacity_bytes = 0;
+  for (auto _ : state) {
+    int64_t baseline_rss = ReadStatusBytes("VmRSS:");
+    ResetPeakRss();
+    Vector<int, std::allocator<int>, GrowthPolicy> vec;
+    for (int i = 0; i < state.range(0); ++i) {
+      if (vec.Size() == vec.Capacity() && !vec.IsMapped()) {
+        bytes_copied += vec.Size() * sizeof(int);  // about to reallocate by copying
+      }
+      vec.PushBack(i);
+    }
+    benchmark::DoNotOptimize(vec.Data());
+    peak_rss = std::max(peak_rss, ReadStatusBytes("VmHWM:") - baseline_rss);
+    capacity_bytes = vec.Capacity() * sizeof(int);
+  }
+  state.counters["bytes_copied"] = benchmark::Counter(bytes_copied, benchmark::Counter::kAvgIterations,
+                                                      benchmark::Counter::kIs1024);
+  state.counters["peak_rss"] = benchmark::Counter(peak_rss, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+  state.counters["capacity"] = benchmark::Counter(capacity_bytes, benchmark::Counter::kDefaults,
+                                                  benchmark::Counter::kIs1024);
+}
+
+const int FILL_SIZE = 1 << 24;
+const int FILL_CHUNK = 1 << 12;
+
+// Unlinked temp file with FILL_SIZE ints, shared by all BM_Fill* benchmarks
+int FillInputFile() {
+  static int fd = [] {
+    char path[] = "/tmp/vector_stress_XXXXXX";
+    int file = mkstemp(path);
+    unlink(path);
+    std::vector<int> data(FILL_SIZE);
+    std::iota(data.begin(), data.end(), 0);
+    if (write(file, data.data(), data.size() * sizeof(int)) != static_cast<ssize_t>(data.size() * sizeof(int))) {
+      std::abort();
+    }
+    return file;
+  }();
+  return fd;
+}
+
+// pread() until `bytes` bytes are in buffer; returns bytes read
+size_t ReadAll(int fd, void* buffer, size_t bytes, off_t offset) {
+  size_t done = 0;
+  while (done < bytes) {
+    ssize_t got = pread(fd, static_cast<char*>(buffer) + done, bytes - done, offset + done);
+    if (got <= 0) {
+      break;
+    }
+    done += got;
+  }
+  return done;
+}
+
+void BM_FillPushBack(benchmark::State& state) {
+  int fd = FillInputFile();
+  int chunk[FILL_CHUNK];
+  for (auto _ : state) {
+    Vector<int> vec;
+    for (off_t offset = 0; offset < FILL_SIZE; offset += FILL_CHUNK) {
+      ReadAll(fd, chunk, sizeof(chunk), offset * sizeof(int));
+      for (int value : chunk) {
+        vec.PushBack(value);
+      }
+    }
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * FILL_SIZE * sizeof(int));
+}
+
+void BM_FillAppendRange(benchmark::State& state) {
+  int fd = FillInputFile();
+  int chunk[FILL_CHUNK];
+  for (auto _ : state) {
+    Vector<int> vec;
+    for (off_t offset = 0; offset < FILL_SIZE; offset += FILL_CHUNK) {
+      ReadAll(fd, chunk, sizeof(chunk), offset * sizeof(int));
+      vec.AppendRange(chunk, chunk + FILL_CHUNK);
+    }
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * FILL_SIZE * sizeof(int));
+}
+
+void BM_FillResize(benchmark::State& state) {
+  int fd = FillInputFile();
+  for (auto _ : state) {
+    Vector<int> vec;
+    vec.Resize(FILL_SIZE, 0);  // zero-fills what read() overwrites right away
+    ReadAll(fd, vec.Data(), FILL_SIZE * sizeof(int), 0);
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * FILL_SIZE * sizeof(int));
+}
+
+void BM_FillResizeUninitialized(benchmark::State& state) {
+  int fd = FillInputFile();
+  for (auto _ : state) {
+    Vector<int> vec;
+    vec.ResizeUninitialized(FILL_SIZE);
+    ReadAll(fd, vec.Data(), FILL_SIZE * sizeof(int), 0);
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * FILL_SIZE * sizeof(int));
+}
+
+void BM_FillDefaultInitConstructor(benchmark::State& state) {
+  int fd = FillInputFile();
+  for (auto _ : state) {
+    Vector<int> vec(FILL_SIZE, DefaultInit);
+    ReadAll(fd, vec.Data(), FILL_SIZE * sizeof(int), 0);
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * FILL_SIZE * sizeof(int));
+}
+
+void BM_StdVectorFillResize(benchmark::State& state) {
+  int fd = FillInputFile();
+  for (auto _ : state) {
+    std::vector<int> vec(FILL_SIZE);
+    ReadAll(fd, vec.data(), FILL_SIZE * sizeof(int), 0);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetBytesProcessed(state.iterations() * FILL_SIZE * sizeof(int));
+}
+
+// Cold start: make the data of size N usable and take one pass over it.
+// BM_ColdStartRebuildVector recomputes it into a fresh Vector; the MmapVector
+// ones reopen a file written in advance, with its pages dropped from the page
+// cache before every iteration.
+
+int64_t ColdStartValue(int64_t i) {
+  return (i * 2654435761) % 1000003;
+}
+
+void BM_ColdStartRebuildVector(benchmark::State& state) {
+  size_t size = state.range(0);
+  for (auto _ : state) {
+    Vector<int64_t> vec;
+    for (size_t i = 0; i < size; ++i) {
+      vec.PushBack(ColdStartValue(i));
+    }
+    benchmark::DoNotOptimize(simd::Sum(vec.Data(), vec.Size()));
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(int64_t));
+}
+
+template <bool FullScan>
+void BM_ColdStartMmapVector(benchmark::State& state) {
+  size_t size = state.range(0);
+  std::string path = "/tmp/vector_stress_mmap_" + std::to_string(getpid());
+  {
+    MmapVector<int64_t> vec(path);
+    vec.Reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      vec.PushBack(ColdStartValue(i));
+    }
+    vec.Flush();
+  }
+  int fd = open(path.c_str(), O_RDONLY);
+  for (auto _ : state) {
+    state.PauseTiming();
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    state.ResumeTiming();
+
+    MmapVector<int64_t> vec(path, MmapVector<int64_t>::OpenMode::ReadOnly);
+    if constexpr (FullScan) {
+      vec.Advise(MmapVector<int64_t>::AccessPattern::Sequential);
+      benchmark::DoNotOptimize(simd::Sum(vec.Data(), vec.Size()));
+    } else {
+      benchmark::DoNotOptimize(vec.Back());
+    }
+  }
+  close(fd);
+  unlink(path.c_str());
+  state.SetBytesProcessed(state.iterations() * size * sizeof(int64_t));
+}
+
+// Multi-producer ingestion: every thread appends PRODUCER_PUSHES records into one shared vector
+const int PRODUCER_PUSHES = 1 << 20;
+
+ConcurrentVector<int64_t>* shared_concurrent_vector = nullptr;
+
+void BM_ConcurrentVectorPushBack(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_concurrent_vector = new ConcurrentVector<int64_t>();
+  }
+  int64_t value = state.thread_index();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shared_concurrent_vector->PushBack(value++));
+  }
+  if (state.thread_index() == 0) {
+    delete shared_concurrent_vector;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+Vector<int64_t>* shared_vector = nullptr;
+std::mutex shared_vector_mutex;
+
+void BM_MutexVectorPushBack(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_vector = new Vector<int64_t>();
+  }
+  int64_t value = state.thread_index();
+  for (auto _ : state) {
+    std::lock_guard guard(shared_vector_mutex);
+    shared_vector->PushBack(value++);
+  }
+  if (state.thread_index() == 0) {
+    delete shared_vector;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Parallel construction: state.range(0) threads build, copy and fill PARALLEL_SIZE elements
+const size_t PARALLEL_SIZE = 1 << 25;
+
+template <typename Body>
+void RunOnThreads(benchmark::State& state, Body body) {
+  ThreadPool pool(state.range(0));
+  SetParallelPool(&pool);
+  SetParallelThreshold(1 << 16);
+  for (auto _ : state) {
+    body();
+  }
+  SetParallelThreshold(std::numeric_limits<size_t>::max());
+  SetParallelPool(nullptr);
+  state.SetBytesProcessed(state.iterations() * PARALLEL_SIZE * sizeof(int64_t));
+}
+
+void BM_ParallelConstruct(benchmark::State& state) {
+  RunOnThreads(state, [] {
+    Vector<int64_t> vec(PARALLEL_SIZE, 7);
+    benchmark::DoNotOptimize(vec.Data());
+  });
+}
+
+void BM_ParallelCopy(benchmark::State& state) {
+  Vector<int64_t> source(PARALLEL_SIZE, 7);
+  RunOnThreads(state, [&] {
+    Vector<int64_t> copy(source);
+    benchmark::DoNotOptimize(copy.Data());
+  });
+}
+
+void BM_ParallelResize(benchmark::State& state) {
+  RunOnThreads(state, [] {
+    Vector<int64_t> vec;
+    vec.Resize(PARALLEL_SIZE, 7);
+    benchmark::DoNotOptimize(vec.Data());
+  });
+}
+
+// Random reads from a 1 GB buffer: TLB misses dominate unless it sits on huge pages
+const size_t GATHER_SIZE = (size_t{1} << 30) / sizeof(int64_t);
+const size_t GATHER_READS = 1 << 22;
+
+template <typename Vec>
+void BM_Gather(benchmark::State& state) {
+  Vec vec;
+  vec.ResizeUninitialized(GATHER_SIZE);
+  std::iota(vec.Data(), vec.Data() + GATHER_SIZE, 0);
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<size_t> dist(0, GATHER_SIZE - 1);
+  Vector<size_t> indices;
+  for (size_t i = 0; i < GATHER_READS; ++i) {
+    indices.PushBack(dist(gen));
+  }
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < GATHER_READS; ++i) {
+      sum += vec[indices[i]];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * GATHER_READS);
+  state.counters["huge_pages"] = benchmark::Counter(
+      ReadStatusBytes("AnonHugePages:", "/proc/self/smaps_rollup"), benchmark::Counter::kDefaults,
+      benchmark::Counter::kIs1024);
+}
+
+// Removing state.range(1) percent of ERASE_SIZE elements chosen at random
+const int ERASE_SIZE = 1 << 20;
+
+Vector<size_t> RandomEraseIndices(size_t size, int percent) {
+  Vector<size_t> indices;
+  std::mt19937 gen(42);
+  std::bernoulli_distribution removed(percent / 100.0);
+  for (size_t i = 0; i < size; ++i) {
+    if (removed(gen)) {
+      indices.PushBack(i);
+    }
+  }
+  return indices;
+}
+
+template <typename Erase>
+void RunEraseBenchmark(benchmark::State& state, Erase erase) {
+  size_t size = state.range(0);
+  Vector<int> source;
+  for (size_t i = 0; i < size; ++i) {
+    source.PushBack(i);
+  }
+  Vector<size_t> indices = RandomEraseIndices(size, state.range(1));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Vector<int> vec(source);
+    state.ResumeTiming();
+    erase(vec, indices);
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_EraseIf(benchmark::State& state) {
+  Vector<size_t> indices = RandomEraseIndices(state.range(0), state.range(1));
+  Vector<bool> removed(state.range(0), false);
+  for (size_t i = 0; i < indices.Size(); ++i) {
+    removed[indices[i]] = true;
+  }
+  RunEraseBenchmark(state, [&](Vector<int>& vec, const Vector<size_t>&) {
+    vec.EraseIf([&](int value) { return removed[value]; });
+  });
+}
+
+void BM_EraseIndices(benchmark::State& state) {
+  RunEraseBenchmark(state, [](Vector<int>& vec, const Vector<size_t>& indices) {
+    vec.EraseIndices(indices.Data(), indices.Data() + indices.Size());
+  });
+}
+
+// The old way: one Erase per element, back to front so positions stay valid
+void BM_RepeatedErase(benchmark::State& state) {
+  RunEraseBenchmark(state, [](Vector<int>& vec, const Vector<size_t>& indices) {
+    for (const size_t* pos = indices.Data() + indices.Size(); pos != indices.Data(); --pos) {
+      vec.Erase(pos[-1], pos[-1] + 1);
+    }
+  });
+}
+
+// Text editor session over a 1 MB document: the cursor mostly moves by a few
+// characters between keystrokes and sometimes jumps elsewhere
+void InsertAt(std::vector<char>& text, size_t pos, char c) {
+  text.insert(text.begin() + pos, c);
+}
+
+void EraseAt(std::vector<char>& text, size_t pos) {
+  text.erase(text.begin() + pos);
+}
+
+size_t TextSize(const std::vector<char>& text) {
+  return text.size();
+}
+
+template <typename Text>
+void InsertAt(Text& text, size_t pos, char c) {
+  text.Insert(pos, c);
+}
+
+template <typename Text>
+void EraseAt(Text& text, size_t pos) {
+  text.Erase(pos, pos + 1);
+}
+
+template <typename Text>
+size_t TextSize(const Text& text) {
+  return text.Size();
+}
+
+template <typename Text>
+void BM_EditorWorkload(benchmark::State& state) {
+  const size_t document_size = 1 << 20;
+  const int keystrokes = 1 << 16;
+  for (auto _ : state) {
+    state.PauseTiming();
+    Text text;
+    for (size_t i = 0; i < document_size; ++i) {
+      InsertAt(text, i, 'a' + i % 26);
+    }
+    std::mt19937 gen(42);
+    size_t cursor = document_size / 2;
+    state.ResumeTiming();
+    for (int i = 0; i < keystrokes; ++i) {
+      int action = gen() % 100;
+      if (action == 0) {
+        cursor = gen() % TextSize(text);
+      } else if (action < 10) {
+        cursor = std::min(TextSize(text), cursor + gen() % 16);
+        cursor -= std::min(cursor, size_t{gen() % 16});
+      } else if (action < 80) {
+        InsertAt(text, cursor++, 'x');
+      } else if (cursor > 0) {
+        EraseAt(text, --cursor);
+      }
+    }
+    benchmark::DoNotOptimize(TextSize(text));
+  }
+  state.SetItemsProcessed(state.iterations() * keystrokes);
+}
+
+// Summing one 8-byte field of 48-byte records: the array of structs drags the
+// other 40 bytes of every record through the cache
+const size_t RECORD_COUNT = 10'000'000;
+
+struct Record {
+  double price;
+  int64_t id;
+  int32_t quantity;
+  std::array<char, 28> name;
+};
+
+void BM_RecordScanAos(benchmark::State& state) {
+  Vector<Record> records;
+  records.Reserve(RECORD_COUNT);
+  for (size_t i = 0; i < RECORD_COUNT; ++i) {
+    records.PushBack(Record{i * 0.25, static_cast<int64_t>(i), 1, {}});
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (size_t i = 0; i < RECORD_COUNT; ++i) {
+      sum += records[i].price;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * RECORD_COUNT * sizeof(double));
+}
+
+void BM_RecordScanSoa(benchmark::State& state) {
+  SoaVector<double, int64_t, int32_t, std::array<char, 28>> records;
+  records.Reserve(RECORD_COUNT);
+  for (size_t i = 0; i < RECORD_COUNT; ++i) {
+    records.PushBack(i * 0.25, static_cast<int64_t>(i), 1, {});
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (double price : records.Span<0>()) {
+      sum += price;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * RECORD_COUNT * sizeof(double));
+}
+
+// 1 GB snapshots written to and read from an unlinked file in /tmp (page cache, not disk)
+const size_t SNAPSHOT_SIZE = (size_t{1} << 30) / sizeof(int64_t);
+
+int SnapshotFile() {
+  char path[] = "/tmp/vector_stress_XXXXXX";
+  int fd = mkstemp(path);
+  unlink(path);
+  return fd;
+}
+
+Vector<int64_t> SnapshotData() {
+  Vector<int64_t> vec;
+  vec.ResizeUninitialized(SNAPSHOT_SIZE);
+  std::iota(vec.Data(), vec.Data() + SNAPSHOT_SIZE, 0);
+  return vec;
+}
+
+// A file holding one snapshot of SnapshotData(), written once for all the load benchmarks
+int SnapshotInputFile() {
+  static int fd = [] {
+    int file = SnapshotFile();
+    Serialize(SnapshotData(), file);
+    return file;
+  }();
+  return fd;
+}
+
+// The old way: one buffered fwrite per element
+void BM_SerializeByElement(benchmark::State& state) {
+  Vector<int64_t> vec = SnapshotData();
+  int fd = SnapshotFile();
+  for (auto _ : state) {
+    state.PauseTiming();
+    if (ftruncate(fd, 0) != 0) {
+      std::abort();
+    }
+    // The duplicate shares the file offset, so rewind it as BM_Serialize does
+    lseek(fd, 0, SEEK_SET);
+    FILE* file = fdopen(dup(fd), "w");
+    state.ResumeTiming();
+    for (size_t i = 0; i < vec.Size(); ++i) {
+      std::fwrite(&vec[i], sizeof(int64_t), 1, file);
+    }
+    std::fclose(file);
+  }
+  close(fd);
+  state.SetBytesProcessed(state.iterations() * SNAPSHOT_SIZE * sizeof(int64_t));
+}
+
+void BM_Serialize(benchmark::State& state) {
+  Vector<int64_t> vec = SnapshotData();
+  int fd = SnapshotFile();
+  for (auto _ : state) {
+    state.PauseTiming();
+    if (ftruncate(fd, 0) != 0) {
+      std::abort();
+    }
+    lseek(fd, 0, SEEK_SET);
+    state.ResumeTiming();
+    Serialize(vec, fd);
+  }
+  close(fd);
+  state.SetBytesProcessed(state.iterations() * SNAPSHOT_SIZE * sizeof(int64_t));
+}
+
+// Loads into the same Vector every iteration: its buffer is already reserved
+void BM_Load(benchmark::State& state) {
+  int fd = SnapshotInputFile();
+  Vector<int64_t> vec;
+  for (auto _ : state) {
+    lseek(fd, 0, SEEK_SET);
+    Load(fd, vec);
+    benchmark::DoNotOptimize(vec.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * SNAPSHOT_SIZE * sizeof(int64_t));
+}
+
+template <ChecksumCheck Check>
+void BM_LoadView(benchmark::State& state) {
+  int fd = SnapshotInputFile();
+  for (auto _ : state) {
+    VectorView<int64_t> view(fd, Check);
+    benchmark::DoNotOptimize(view[view.Size() - 1]);
+  }
+  state.SetBytesProcessed(state.iterations() * SNAPSHOT_SIZE * sizeof(int64_t));
+}
+
+// Read-only snapshots: a deep Vector copy against a CowVector copy
+template <typename Vec>
+Vec MakeSnapshotSource(size_t size) {
+  Vector<int64_t> vec;
+  vec.ResizeUninitialized(size);
+  std::iota(vec.Data(), vec.Data() + size, 0);
+  if constexpr (std::is_same_v<Vec, Vector<int64_t>>) {
+    return vec;
+  } else {
+    return Vec(std::move(vec));
+  }
+}
+
+template <typename Vec>
+void BM_TakeSnapshot(benchmark::State& state) {
+  const Vec source = MakeSnapshotSource<Vec>(state.range(0));
+  for (auto _ : state) {
+    Vec snapshot(source);
+    benchmark::DoNotOptimize(snapshot.Data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Every reader thread repeatedly takes a snapshot of one shared vector and sums it
+const size_t READER_SNAPSHOT_SIZE = 1 << 16;
+
+template <typename Vec>
+void BM_SnapshotReaders(benchmark::State& state) {
+  static const Vec source = MakeSnapshotSource<Vec>(READER_SNAPSHOT_SIZE);
+  for (auto _ : state) {
+    const Vec snapshot(source);
+    benchmark::DoNotOptimize(simd::Sum(snapshot.Data(), snapshot.Size()));
+  }
+  state.SetItemsProcessed(state.iterations() * READER_SNAPSHOT_SIZE);
+}
+
+// Values in [0, 1000): searching for -1 always scans the whole buffer
+template <typename T>
+Vector<T> MakeArithmeticVector(int64_t size) {
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, 999);
+  Vector<T> vec;
+  vec.Reserve(size);
+  for (int64_t i = 0; i < size; ++i) {
+    vec.PushBack(static_cast<T>(dist(mt)));
+  }
+  return vec;
+}
+
+template <typename T>
+void BM_SimdFind(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(simd::Find(vec, T(-1)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_StdFind(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::find(vec.Data(), vec.Data() + vec.Size(), T(-1)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_SimdCount(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(simd::Count(vec, T(7)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_StdCount(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::count(vec.Data(), vec.Data() + vec.Size(), T(7)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_SimdMinMax(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(simd::Min(vec));
+    benchmark::DoNotOptimize(simd::Max(vec));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_StdMinMaxElement(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::minmax_element(vec.Data(), vec.Data() + vec.Size()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_SimdSum(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(simd::Sum(vec));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_ScalarSum(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(simd::Sum(vec, simd::Level::Scalar));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void BM_StdAccumulate(benchmark::State& state) {
+  auto vec = MakeArithmeticVector<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::accumulate(vec.Data(), vec.Data() + vec.Size(), simd::SumType<T>{}));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
 
 BENCHMARK(BM_CustomVectorPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdVectorPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
-BENCHMARK(BM_CustomVectorMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomVectorPushBackWithAllocator, std::allocator<int>)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomVectorPushBackWithAllocator, mi_stl_allocator<int>)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomVectorPushBackArena)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomVectorMiddleInsert, int)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomVectorMiddleInsert, RelocatableHandle)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomVectorMiddleInsert, PlainHandle)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GapVectorMiddleInsert, int)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GapVectorMiddleInsert, RelocatableHandle)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GapVectorMiddleInsert, PlainHandle)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdVectorMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SmallVectorPushBack, Vector<int>)->Arg(4)->Arg(8)->Arg(16)->Arg(17)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(BM_SmallVectorPushBack, SmallVector<int, 16>)->Arg(4)->Arg(8)->Arg(16)->Arg(17)->Arg(32)->Arg(64);
+BENCHMARK(BM_StdVectorSmallPushBack)->Arg(4)->Arg(8)->Arg(16)->Arg(17)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(BM_VectorGrowthPolicy, DoublingGrowth)->RangeMultiplier(4)->Range(1<<20, 1<<26)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_VectorGrowthPolicy, OneAndHalfGrowth)->RangeMultiplier(4)->Range(1<<20, 1<<26)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_VectorGrowthPolicy, HugeBufferGrowth<>)->RangeMultiplier(4)->Range(1<<20, 1<<26)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FillPushBack)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FillAppendRange)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FillResize)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FillResizeUninitialized)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FillDefaultInitConstructor)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdVectorFillResize)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ColdStartRebuildVector)->RangeMultiplier(16)->Range(1<<16, 1<<24)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ColdStartMmapVector, true)->RangeMultiplier(16)->Range(1<<16, 1<<24)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ColdStartMmapVector, false)->RangeMultiplier(16)->Range(1<<16, 1<<24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConcurrentVectorPushBack)->Iterations(PRODUCER_PUSHES)->ThreadRange(1, std::thread::hardware_concurrency())->UseRealTime();
+BENCHMARK(BM_MutexVectorPushBack)->Iterations(PRODUCER_PUSHES)->ThreadRange(1, std::thread::hardware_concurrency())->UseRealTime();
+BENCHMARK(BM_ParallelConstruct)->RangeMultiplier(2)->Range(1, std::thread::hardware_concurrency())->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelCopy)->RangeMultiplier(2)->Range(1, std::thread::hardware_concurrency())->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelResize)->RangeMultiplier(2)->Range(1, std::thread::hardware_concurrency())->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Gather, Vector<int64_t>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Gather, AlignedVector<int64_t>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Gather, HugePageVector<int64_t>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EraseIf)->ArgsProduct({{ERASE_SIZE}, {1, 10, 50}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EraseIndices)->ArgsProduct({{ERASE_SIZE}, {1, 10, 50}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RepeatedErase)->ArgsProduct({{ERASE_SIZE >> 4}, {1, 10, 50}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EditorWorkload, Vector<char>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EditorWorkload, GapVector<char>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EditorWorkload, std::vector<char>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RecordScanAos)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RecordScanSoa)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SerializeByElement)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Serialize)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Load)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadView, ChecksumCheck::Verify)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadView, ChecksumCheck::Skip)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TakeSnapshot, Vector<int64_t>)->RangeMultiplier(16)->Range(1<<8, 1<<24)->Complexity();
+BENCHMARK_TEMPLATE(BM_TakeSnapshot, CowVector<int64_t>)->RangeMultiplier(16)->Range(1<<8, 1<<24)->Complexity();
+BENCHMARK_TEMPLATE(BM_SnapshotReaders, Vector<int64_t>)->ThreadRange(1, std::thread::hardware_concurrency())->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SnapshotReaders, CowVector<int64_t>)->ThreadRange(1, std::thread::hardware_concurrency())->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SimdFind, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_SimdFind, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdFind, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdFind, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_SimdCount, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_SimdCount, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdCount, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdCount, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_SimdMinMax, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_SimdMinMax, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdMinMaxElement, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdMinMaxElement, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_SimdSum, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_SimdSum, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_ScalarSum, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_ScalarSum, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdAccumulate, int)->RangeMultiplier(8)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_StdAccumulate, float)->RangeMultiplier(8)->Range(1<<10, 1<<24);
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "../vector.hpp"
+#include "../vector.cpp"
+#include "../vector_stats_counters.hpp"
+
+#include <climits>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+// Built with VECTOR_STATS, unlike stress_tests: the stats hooks update shared
+// atomics on every reallocation, which would skew the comparisons there.
+// This target only reports the reallocation counters of the PushBack workload.
+void BM_CustomVectorPushBackStats(benchmark::State& state) {
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  Vector<int> vec;
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      vec.PushBack(dist(mt));
+    }
+  }
+  ReportVectorStats(state, vec.Stats());
+}
+
+BENCHMARK(BM_CustomVectorPushBackStats)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,17 +1,45 @@
 #include "../vector.hpp"
 #include "../vector.cpp"
+#include "../simd.hpp"
+#include "../mmap_vector.hpp"
+#include "../mmap_vector.cpp"
+#include "../concurrent_vector.hpp"
+#include "../concurrent_vector.cpp"
+#include "../gap_vector.hpp"
+#include "../gap_vector.cpp"
+#include "../soa_vector.hpp"
+#include "../soa_vector.cpp"
+#include "../vector_io.hpp"
+#include "../vector_io.cpp"
+#include "../cow_vector.hpp"
+#include "../cow_vector.cpp"
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <climits>
+#include <cstring>
+#include <filesystem>
 #include <future>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
 #include <memory>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 class Singleton {
 private:
     Singleton() {}
@@ -428,6 +456,1269 @@ TEST_F(VectorTest, VectorResizeLessThenCurrent) {
     }
 }
 
+TEST(VectorResizeTest, FillWithOwnElement) {
+    Vector<std::string> vec;
+    vec.PushBack(std::string(40, 'q'));
+    vec.Resize(100, vec[0]);  // needs reallocation, which frees the old vec[0]
+    ASSERT_EQ(vec.Size(), 100);
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        ASSERT_EQ(vec[i], std::string(40, 'q'));
+    }
+}
+
+TEST(SmallVectorTest, StaysInlineUpToN) {
+    SmallVector<int, 16> vec;
+    ASSERT_EQ(vec.Capacity(), 16);
+    ASSERT_TRUE(vec.IsInline());
+    for (int i = 0; i < 16; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_TRUE(vec.IsInline()) << "First N elements must not touch the heap!";
+    vec.PushBack(16);
+    ASSERT_FALSE(vec.IsInline());
+    ASSERT_GT(vec.Capacity(), 16);
+    for (int i = 0; i < 17; ++i) {
+        ASSERT_EQ(vec[i], i);
+    }
+}
+
+TEST(SmallVectorTest, ReserveSpillsToHeap) {
+    SmallVector<std::string, 4> vec;
+    vec.PushBack("a");
+    vec.PushBack("b");
+    vec.Reserve(4);
+    ASSERT_TRUE(vec.IsInline());
+    vec.Reserve(100);
+    ASSERT_FALSE(vec.IsInline());
+    ASSERT_EQ(vec.Capacity(), 100);
+    ASSERT_EQ(vec[0], "a");
+    ASSERT_EQ(vec[1], "b");
+}
+
+TEST(SmallVectorTest, CopyAndMoveInline) {
+    SmallVector<std::string, 4> vec = {"a", "b", "c"};
+    SmallVector<std::string, 4> copy = vec;
+    ASSERT_TRUE(copy.IsInline());
+    ASSERT_EQ(copy.Size(), 3);
+    ASSERT_EQ(copy[2], "c");
+
+    SmallVector<std::string, 4> moved = std::move(vec);
+    ASSERT_TRUE(moved.IsInline());
+    ASSERT_EQ(moved.Size(), 3);
+    ASSERT_EQ(moved[0], "a");
+    ASSERT_EQ(vec.Size(), 0);
+
+    copy = moved;
+    ASSERT_EQ(copy.Size(), 3);
+    ASSERT_EQ(copy[1], "b");
+}
+
+TEST(SmallVectorTest, MoveHeapStealsBuffer) {
+    SmallVector<MemoryUseObject, 2> vec;
+    for (int i = 0; i < 5; ++i) {
+        vec.EmplaceBack();
+    }
+    auto data = vec.Data();
+    SmallVector<MemoryUseObject, 2> moved = std::move(vec);
+    ASSERT_EQ(moved.Data(), data) << "Heap buffer must be stolen, not copied!";
+    ASSERT_EQ(moved.Size(), 5);
+    ASSERT_TRUE(vec.IsInline());
+    ASSERT_EQ(vec.Size(), 0);
+    ASSERT_EQ(vec.Capacity(), 2);
+}
+
+TEST(SmallVectorTest, SwapMixedStorage) {
+    SmallVector<std::string, 4> small = {"x", "y"};
+    SmallVector<std::string, 4> big;
+    for (int i = 0; i < 10; ++i) {
+        big.PushBack(std::to_string(i));
+    }
+    std::swap(small, big);
+    ASSERT_EQ(small.Size(), 10);
+    ASSERT_FALSE(small.IsInline());
+    ASSERT_EQ(small[9], "9");
+    ASSERT_EQ(big.Size(), 2);
+    ASSERT_TRUE(big.IsInline());
+    ASSERT_EQ(big[1], "y");
+
+    SmallVector<std::string, 4> other = {"p", "q", "r"};
+    big.Swap(other);
+    ASSERT_EQ(big.Size(), 3);
+    ASSERT_EQ(big[2], "r");
+    ASSERT_EQ(other.Size(), 2);
+    ASSERT_EQ(other[0], "x");
+}
+
+// Copyable with a move that may throw, so Vector relocates it by copying
+struct ThrowOnCopy {
+    explicit ThrowOnCopy(int value) : value(value) {
+    }
+
+    ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+        if (throw_on_copy) {
+            throw std::runtime_error("copy");
+        }
+    }
+
+    ThrowOnCopy& operator=(const ThrowOnCopy&) = default;
+
+    static inline bool throw_on_copy = false;
+
+    int value;
+};
+
+TEST(SmallVectorTest, MoveInlineWithThrowingCopy) {
+    using ThrowingSmallVector = SmallVector<ThrowOnCopy, 4>;
+    static_assert(!std::is_nothrow_move_constructible_v<ThrowingSmallVector>);
+    static_assert(std::is_nothrow_move_constructible_v<SmallVector<std::string, 4>>);
+    static_assert(std::is_nothrow_move_constructible_v<Vector<ThrowOnCopy>>);
+
+    ThrowingSmallVector vec;
+    vec.EmplaceBack(1);
+    vec.EmplaceBack(2);
+    ThrowOnCopy::throw_on_copy = true;
+    ASSERT_THROW(ThrowingSmallVector{std::move(vec)}, std::runtime_error);
+    ASSERT_EQ(vec.Size(), 2) << "A failed move must leave the source intact";
+
+    ThrowingSmallVector target;
+    ASSERT_THROW(target = std::move(vec), std::runtime_error);
+    ASSERT_EQ(target.Size(), 0);
+    ASSERT_EQ(vec.Size(), 2);
+
+    ThrowOnCopy::throw_on_copy = false;
+    ThrowingSmallVector big;
+    for (int i = 0; i < 10; ++i) {
+        big.EmplaceBack(i);
+    }
+    ThrowOnCopy::throw_on_copy = true;
+    ASSERT_THROW(vec.Swap(big), std::runtime_error);
+    ThrowOnCopy::throw_on_copy = false;
+    ASSERT_EQ(vec.Size(), 2);
+    ASSERT_EQ(vec[1].value, 2);
+    ASSERT_EQ(big.Size(), 10) << "The heap side must get its buffer back";
+    ASSERT_EQ(big[9].value, 9);
+}
+
+struct RelocatableObject {
+    explicit RelocatableObject(int value) : value(std::make_unique<int>(value)) {
+    }
+
+    std::unique_ptr<int> value;
+};
+
+template <>
+struct IsTriviallyRelocatable<RelocatableObject> : std::true_type {};
+
+TEST(RelocationTest, TraitDetection) {
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(IsTriviallyRelocatableV<int*>);
+    static_assert(IsTriviallyRelocatableV<RelocatableObject>);
+    static_assert(!IsTriviallyRelocatableV<MemoryUseObject>);
+}
+
+TEST(RelocationTest, InsertEraseOptInType) {
+    Vector<RelocatableObject> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.EmplaceBack(i);
+    }
+    vec.Insert(5, RelocatableObject(100));  // triggers reallocation
+    vec.Insert(0, RelocatableObject(-1));
+    ASSERT_EQ(vec.Size(), 12);
+    ASSERT_EQ(*vec[0].value, -1);
+    ASSERT_EQ(*vec[6].value, 100);
+    ASSERT_EQ(*vec[11].value, 9);
+
+    vec.Erase(2, 7);
+    ASSERT_EQ(vec.Size(), 7);
+    ASSERT_EQ(*vec[0].value, -1);
+    ASSERT_EQ(*vec[1].value, 0);
+    ASSERT_EQ(*vec[2].value, 5);
+    ASSERT_EQ(*vec[6].value, 9);
+}
+
+// Allocator with state: counts the elements it currently holds
+template <typename T>
+struct TrackingAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+
+    explicit TrackingAllocator(size_t* live) : live(live) {
+    }
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U>& other) : live(other.live) {  // NOLINT
+    }
+
+    T* allocate(size_t count) {
+        *live += count;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        *live -= count;
+        std::allocator<T>().deallocate(ptr, count);
+    }
+
+    bool operator==(const TrackingAllocator& other) const {
+        return live == other.live;
+    }
+
+    size_t* live;
+};
+
+TEST(AllocatorTest, AllAllocationsGoThroughAllocator) {
+    size_t live = 0;
+    {
+        Vector<std::string, TrackingAllocator<std::string>> vec{TrackingAllocator<std::string>(&live)};
+        for (int i = 0; i < 100; ++i) {
+            vec.PushBack(std::to_string(i));
+        }
+        ASSERT_EQ(live, vec.Capacity());
+        vec.Insert(0, "front");
+        vec.Reserve(1000);
+        ASSERT_EQ(live, 1000);
+        auto copy = vec;
+        ASSERT_EQ(live, 1000 + copy.Capacity());
+        ASSERT_EQ(copy[0], "front");
+    }
+    ASSERT_EQ(live, 0);
+}
+
+TEST(AllocatorTest, MoveAssignBetweenUnequalAllocators) {
+    size_t first_live = 0;
+    size_t second_live = 0;
+    using Alloc = TrackingAllocator<int>;
+    Vector<int, Alloc> first{Alloc(&first_live)};
+    Vector<int, Alloc> second{Alloc(&second_live)};
+    for (int i = 0; i < 20; ++i) {
+        second.PushBack(i);
+    }
+    first = std::move(second);  // allocator does not propagate: elements are moved one by one
+    ASSERT_EQ(first.Size(), 20);
+    ASSERT_EQ(first[19], 19);
+    ASSERT_EQ(first_live, first.Capacity());
+    ASSERT_EQ(first.GetAllocator().live, &first_live);
+    ASSERT_EQ(second.Size(), 0);
+}
+
+TEST(AllocatorTest, PolymorphicAllocator) {
+    std::pmr::monotonic_buffer_resource arena;
+    Vector<int, std::pmr::polymorphic_allocator<int>> vec(&arena);
+    for (int i = 0; i < 1000; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_EQ(vec.GetAllocator().resource(), &arena);
+    ASSERT_EQ(vec[999], 999);
+}
+
+TEST(GrowthPolicyTest, OneAndHalf) {
+    Vector<int, std::allocator<int>, OneAndHalfGrowth> vec;
+    for (int i = 0; i < 11; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_EQ(vec.Capacity(), 15);
+    for (int i = 11; i < 16; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_EQ(vec.Capacity(), 22);
+    for (int i = 0; i < 16; ++i) {
+        ASSERT_EQ(vec[i], i);
+    }
+}
+
+TEST(GrowthPolicyTest, HugeBufferGrowsInPlace) {
+    using HugeVector = Vector<int, std::allocator<int>, HugeBufferGrowth<4096>>;
+    HugeVector vec;
+    for (int i = 0; i < 500; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_FALSE(vec.IsMapped()) << "Small buffers must come from the allocator!";
+    for (int i = 500; i < 100000; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_TRUE(vec.IsMapped());
+    vec.Insert(50000, -1);
+    vec.Erase(0, 1);
+    ASSERT_EQ(vec.Size(), 100000);
+    ASSERT_EQ(vec[49999], -1);
+    ASSERT_EQ(vec[99999], 99999);
+
+    HugeVector copy = vec;
+    ASSERT_TRUE(copy.IsMapped());
+    HugeVector moved = std::move(vec);
+    ASSERT_TRUE(moved.IsMapped());
+    ASSERT_FALSE(vec.IsMapped());
+    for (size_t i = 0; i < moved.Size(); ++i) {
+        ASSERT_EQ(moved[i], copy[i]);
+    }
+}
+
+TEST(BulkAppendTest, AppendRange) {
+    Vector<std::string> vec = {"a", "b"};
+    std::list<std::string> words = {"c", "d", "e"};
+    vec.AppendRange(words.begin(), words.end());
+    ASSERT_EQ(vec.Size(), 5);
+    ASSERT_EQ(vec[4], "e");
+
+    std::istringstream input("f g");
+    vec.AppendRange(std::istream_iterator<std::string>(input), std::istream_iterator<std::string>());
+    ASSERT_EQ(vec.Size(), 7);
+    ASSERT_EQ(vec[6], "g");
+}
+
+TEST(BulkAppendTest, AppendRangeOfItself) {
+    Vector<int> vec = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    vec.AppendRange(vec.Data(), vec.Data() + vec.Size());  // needs reallocation
+    ASSERT_EQ(vec.Size(), 20);
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(vec[i], i % 10 + 1);
+    }
+}
+
+TEST(BulkAppendTest, DefaultInit) {
+    Vector<int> vec(100, DefaultInit);
+    ASSERT_EQ(vec.Size(), 100);
+    ASSERT_GE(vec.Capacity(), 100);
+
+    vec.ResizeUninitialized(1000);
+    ASSERT_EQ(vec.Size(), 1000);
+    vec.ResizeUninitialized(10);
+    ASSERT_EQ(vec.Size(), 10);
+
+    Vector<std::string> strings;
+    strings.ResizeDefaultInit(3);
+    ASSERT_EQ(strings.Size(), 3);
+    ASSERT_TRUE(strings[2].empty());
+}
+
+template <typename T>
+void CheckSimdLevelsAgree(const Vector<T>& vec, T needle) {
+    std::vector<simd::Level> levels = {simd::Level::Scalar};
+#if defined(__x86_64__)
+    levels.push_back(simd::Level::Sse2);
+    if (__builtin_cpu_supports("avx2")) {
+        levels.push_back(simd::Level::Avx2);
+    }
+#endif
+    auto data = vec.Data();
+    size_t expected_find = std::find(data, data + vec.Size(), needle) - data;
+    size_t expected_count = std::count(data, data + vec.Size(), needle);
+    for (auto level : levels) {
+        ASSERT_EQ(simd::Find(vec, needle, level), expected_find);
+        ASSERT_EQ(simd::Count(vec, needle, level), expected_count);
+        if (vec.IsEmpty()) {
+            continue;
+        }
+        ASSERT_EQ(simd::Min(vec, level), *std::min_element(data, data + vec.Size()));
+        ASSERT_EQ(simd::Max(vec, level), *std::max_element(data, data + vec.Size()));
+        auto sum = simd::Sum(vec, level);
+        auto scalar_sum = simd::Sum(vec, simd::Level::Scalar);
+        ASSERT_EQ(std::memcmp(&sum, &scalar_sum, sizeof(sum)), 0) << "Sum must match the scalar one bit for bit";
+    }
+}
+
+TEST(SimdTest, IntKernels) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    for (size_t size : {0, 1, 5, 8, 13, 64, 1000, 100003}) {
+        Vector<int> vec;
+        for (size_t i = 0; i < size; ++i) {
+            vec.PushBack(dist(gen));
+        }
+        CheckSimdLevelsAgree(vec, 7);
+        CheckSimdLevelsAgree(vec, 5000);
+    }
+    Vector<int> big(100, INT_MAX);
+    ASSERT_EQ(simd::Sum(big), int64_t{INT_MAX} * 100) << "Integer sum must not overflow";
+}
+
+TEST(SimdTest, FloatKernels) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-1e6, 1e6);
+    for (size_t size : {0, 1, 5, 8, 13, 64, 1000, 100003}) {
+        Vector<float> vec;
+        for (size_t i = 0; i < size; ++i) {
+            vec.PushBack(dist(gen));
+        }
+        vec.PushBack(0.5f);
+        CheckSimdLevelsAgree(vec, 0.5f);
+        CheckSimdLevelsAgree(vec, 2e7f);
+    }
+}
+
+TEST(SimdTest, ScalarFallbackForOtherTypes) {
+    Vector<double> vec = {3.0, -1.5, 8.0, 2.5};
+    ASSERT_EQ(simd::Find(vec, 8.0), 2);
+    ASSERT_EQ(simd::Min(vec), -1.5);
+    ASSERT_EQ(simd::Max(vec), 8.0);
+    ASSERT_EQ(simd::Sum(vec), 12.0);
+}
+
+// Backing file in the temp directory, removed with the object
+class TempPath {
+public:
+    explicit TempPath(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() / (name + "." + std::to_string(getpid()))) {
+        std::filesystem::remove(path_);
+    }
+
+    ~TempPath() {
+        std::filesystem::remove(path_);
+    }
+
+    std::string Str() const {
+        return path_.string();
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+TEST(MmapVectorTest, PersistsBetweenOpens) {
+    TempPath path("mmap_vector_persist");
+    {
+        MmapVector<int> vec(path.Str());
+        ASSERT_TRUE(vec.IsEmpty());
+        for (int i = 0; i < 100000; ++i) {
+            vec.PushBack(i);
+        }
+        vec.Flush();
+    }
+    MmapVector<int> vec(path.Str());
+    ASSERT_EQ(vec.Size(), 100000);
+    ASSERT_GE(vec.Capacity(), 100000);
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(vec[i], i);
+    }
+    vec.PushBack(-1);
+    ASSERT_EQ(vec.Back(), -1);
+}
+
+TEST(MmapVectorTest, Modifiers) {
+    TempPath path("mmap_vector_modifiers");
+    MmapVector<int> vec(path.Str());
+    vec.Resize(5, 7);
+    vec.Insert(0, 1);
+    vec.Insert(100, 9);
+    vec.Erase(1, 3);
+    vec.EmplaceBack(vec.Front());
+    ASSERT_EQ(vec.Size(), 6);
+    int expected[] = {1, 7, 7, 7, 9, 1};
+    ASSERT_TRUE(std::equal(vec.Data(), vec.Data() + vec.Size(), expected));
+
+    vec.PopBack();
+    vec.Resize(2, 0);
+    ASSERT_EQ(vec.Size(), 2);
+    vec.Clear();
+    ASSERT_TRUE(vec.IsEmpty());
+
+    vec.Reserve(1000);
+    ASSERT_EQ(vec.Capacity(), 1000);
+    ASSERT_EQ(std::filesystem::file_size(path.Str()), 64 + 1000 * sizeof(int));
+}
+
+TEST(MmapVectorTest, ReadOnly) {
+    TempPath path("mmap_vector_read_only");
+    ASSERT_THROW(MmapVector<int>(path.Str(), MmapVector<int>::OpenMode::ReadOnly), MmapVectorException);
+    {
+        MmapVector<int> vec(path.Str());
+        vec.Resize(10, 3);
+    }
+    MmapVector<int> vec(path.Str(), MmapVector<int>::OpenMode::ReadOnly);
+    ASSERT_TRUE(vec.IsReadOnly());
+    ASSERT_EQ(vec.Size(), 10);
+    ASSERT_EQ(vec[9], 3);
+    vec.Advise(MmapVector<int>::AccessPattern::Sequential);
+    vec.Advise(MmapVector<int>::AccessPattern::Random);
+    ASSERT_THROW(vec.PushBack(1), MmapVectorException);
+    ASSERT_THROW(vec.Clear(), MmapVectorException);
+    ASSERT_EQ(vec.Size(), 10);
+
+    ASSERT_THROW(MmapVector<double>{path.Str()}, MmapVectorException) << "Element size is checked on open";
+}
+
+TEST(MmapVectorTest, MoveAndSwap) {
+    TempPath first_path("mmap_vector_first");
+    TempPath second_path("mmap_vector_second");
+    MmapVector<int> first(first_path.Str());
+    MmapVector<int> second(second_path.Str());
+    first.PushBack(1);
+    second.PushBack(2);
+    second.PushBack(3);
+
+    std::swap(first, second);
+    ASSERT_EQ(first.Size(), 2);
+    ASSERT_EQ(second.Front(), 1);
+
+    MmapVector<int> moved(std::move(first));
+    ASSERT_EQ(moved.Back(), 3);
+    ASSERT_TRUE(first.IsEmpty());
+    first = std::move(second);
+    ASSERT_EQ(first.Size(), 1);
+}
+
+TEST(ConcurrentVectorTest, SingleThread) {
+    ConcurrentVector<std::string, 4> vec;
+    ASSERT_TRUE(vec.IsEmpty());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(vec.PushBack(std::to_string(i)), i);
+    }
+    ASSERT_EQ(vec.EmplaceBack(3, 'x'), 1000);
+    ASSERT_EQ(vec.Size(), 1001);
+    ASSERT_GE(vec.Capacity(), 1001);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(vec[i], std::to_string(i));
+    }
+    ASSERT_EQ(vec[1000], "xxx");
+
+    ConcurrentVector<int> reserved;
+    reserved.Reserve(1000);
+    ASSERT_GE(reserved.Capacity(), 1000);
+    ASSERT_TRUE(reserved.IsEmpty());
+}
+
+TEST(ConcurrentVectorTest, ElementsNeverMove) {
+    ConcurrentVector<int, 1> vec;
+    vec.PushBack(42);
+    const int* first = &vec[0];
+    for (int i = 0; i < 100000; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_EQ(first, &vec[0]);
+    ASSERT_EQ(*first, 42);
+}
+
+TEST(ConcurrentVectorTest, ManyProducers) {
+    const int threads_count = 8;
+    const int per_thread = 20000;
+    ConcurrentVector<int64_t, 8> vec;
+    std::atomic<bool> done = false;
+
+    // Reader checks that the published prefix only ever grows and holds complete values
+    std::thread reader([&] {
+        size_t last_size = 0;
+        while (!done) {
+            size_t size = vec.Size();
+            ASSERT_GE(size, last_size);
+            for (size_t i = last_size; i < size; ++i) {
+                ASSERT_GE(vec[i], 0);
+            }
+            last_size = size;
+        }
+    });
+
+    std::vector<std::thread> producers;
+    std::vector<std::vector<size_t>> indices(threads_count);
+    for (int thread = 0; thread < threads_count; ++thread) {
+        producers.emplace_back([&, thread] {
+            for (int i = 0; i < per_thread; ++i) {
+                size_t pos = vec.PushBack(int64_t{thread} * per_thread + i);
+                ASSERT_EQ(vec[pos], int64_t{thread} * per_thread + i);
+                indices[thread].push_back(pos);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    done = true;
+    reader.join();
+
+    ASSERT_EQ(vec.Size(), threads_count * per_thread);
+    std::vector<bool> seen(threads_count * per_thread);
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        ASSERT_FALSE(seen[vec[i]]);
+        seen[vec[i]] = true;
+    }
+    for (int thread = 0; thread < threads_count; ++thread) {
+        for (int i = 0; i < per_thread; ++i) {
+            ASSERT_EQ(vec[indices[thread][i]], int64_t{thread} * per_thread + i);
+        }
+    }
+}
+
+// Runs Vector construction on a pool of 4 threads for anything of at least 100 elements
+class ParallelVectorTest : public testing::Test {
+protected:
+    void SetUp() override {
+        SetParallelPool(&pool_);
+        SetParallelThreshold(100);
+    }
+
+    void TearDown() override {
+        SetParallelThreshold(std::numeric_limits<size_t>::max());
+        SetParallelPool(nullptr);
+    }
+
+    ThreadPool pool_{4};
+};
+
+// Copying throws once copies_left reaches zero; live counts constructed objects
+struct ThrowingCopy {
+    static inline std::atomic<int> live = 0;
+    static inline std::atomic<int> copies_left = 0;
+
+    explicit ThrowingCopy(int value) : value(value) {
+        ++live;
+    }
+
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+        if (copies_left-- <= 0) {
+            throw std::runtime_error("copy failed");
+        }
+        ++live;
+    }
+
+    ~ThrowingCopy() {
+        --live;
+    }
+
+    int value;
+};
+
+TEST_F(ParallelVectorTest, ConstructCopyFill) {
+    Vector<std::string> filled(10000, "value");
+    ASSERT_EQ(filled.Size(), 10000);
+    ASSERT_TRUE(std::all_of(filled.Data(), filled.Data() + filled.Size(), [](auto& s) { return s == "value"; }));
+
+    Vector<int> numbers;
+    for (int i = 0; i < 100000; ++i) {
+        numbers.PushBack(i);
+    }
+    Vector<int> copy(numbers);
+    ASSERT_TRUE(std::equal(numbers.Data(), numbers.Data() + numbers.Size(), copy.Data(), copy.Data() + copy.Size()));
+
+    copy.Resize(300000, -1);
+    ASSERT_EQ(copy[99999], 99999);
+    ASSERT_EQ(std::count(copy.Data(), copy.Data() + copy.Size(), -1), 200000);
+
+    Vector<std::string> strings_copy(filled);
+    ASSERT_EQ(strings_copy[9999], "value");
+}
+
+TEST_F(ParallelVectorTest, ThrowingElementDestroysEverything) {
+    ThrowingCopy::copies_left = 1000000;
+    {
+        Vector<ThrowingCopy> vec(5000, ThrowingCopy(1));
+        ASSERT_EQ(ThrowingCopy::live, 5000);
+
+        for (int fail_after : {0, 1, 2500, 4999}) {
+            ThrowingCopy::copies_left = fail_after;
+            ASSERT_THROW(Vector<ThrowingCopy>{vec}, std::runtime_error);
+            ASSERT_EQ(ThrowingCopy::live, 5000) << "Partially built copy must be destroyed";
+
+            ThrowingCopy::copies_left = fail_after;
+            ASSERT_THROW(vec.Resize(10000, vec[0]), std::runtime_error);
+            ASSERT_EQ(vec.Size(), 5000);
+            ASSERT_EQ(ThrowingCopy::live, 5000);
+        }
+    }
+    ASSERT_EQ(ThrowingCopy::live, 0);
+}
+
+TEST_F(ParallelVectorTest, NestedVectors) {
+    // Every inner vector is above the threshold, so copying and filling the outer
+    // one starts inner parallel loops from tasks, on workers and on this thread
+    Vector<int64_t> inner(1000, 7);
+    Vector<Vector<int64_t>> outer(200, inner);
+    Vector<Vector<int64_t>> copy = outer;
+    copy.Resize(400, inner);
+    ASSERT_EQ(copy.Size(), 400);
+    for (size_t i = 0; i < copy.Size(); ++i) {
+        ASSERT_EQ(copy[i].Size(), 1000);
+        ASSERT_EQ(copy[i][999], 7);
+    }
+}
+
+TEST(ThreadPoolTest, NestedOnSubmittingThread) {
+    ThreadPool pool(2);
+    std::thread::id caller = std::this_thread::get_id();
+    std::atomic<int> nested_on_caller = 0;
+    std::atomic<int> runs = 0;
+    pool.ParallelFor(64, [&](size_t) {
+        pool.ParallelFor(4, [&](size_t) { ++runs; });
+        if (std::this_thread::get_id() == caller) {
+            ++nested_on_caller;
+        }
+        // Slow enough that the worker cannot take every task alone
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    });
+    ASSERT_EQ(runs, 64 * 4);
+    ASSERT_GT(nested_on_caller, 0) << "The submitting thread runs tasks too";
+
+    // Once the outer loop is over, the caller submits to the workers again
+    std::atomic<int> on_worker = 0;
+    pool.ParallelFor(1000, [&](size_t) {
+        if (std::this_thread::get_id() != caller) {
+            ++on_worker;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    });
+    ASSERT_GT(on_worker, 0);
+}
+
+TEST(ThreadPoolTest, ParallelFor) {
+    ThreadPool pool(3);
+    ASSERT_EQ(pool.ThreadCount(), 3);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.ParallelFor(hits.size(), [&](size_t i) {
+        ++hits[i];
+        // Nested loops run on the calling thread
+        pool.ParallelFor(2, [&](size_t) { ++hits[i]; });
+    });
+    ASSERT_TRUE(std::all_of(hits.begin(), hits.end(), [](auto& h) { return h == 3; }));
+
+    std::atomic<int> runs = 0;
+    ASSERT_THROW(pool.ParallelFor(100,
+                                  [&](size_t i) {
+                                      ++runs;
+                                      if (i % 10 == 0) {
+                                          throw std::runtime_error("task failed");
+                                      }
+                                  }),
+                 std::runtime_error);
+    ASSERT_EQ(runs, 100) << "Other tasks must still run";
+}
+
+TEST(VectorStatsTest, PushBack) {
+    Vector<int> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.PushBack(i);
+    }
+    if constexpr (!detail::StatsEnabled) {
+        ASSERT_EQ(vec.Stats().reallocations, 0) << "Stats are off without VECTOR_STATS";
+        ASSERT_EQ(vec.Stats().peak_capacity, 0);
+        return;
+    }
+    // Capacities 10, 20, ..., 1280
+    ASSERT_EQ(vec.Stats().reallocations, 8);
+    ASSERT_EQ(vec.Stats().bytes_moved, (10 + 20 + 40 + 80 + 160 + 320 + 640) * sizeof(int));
+    ASSERT_EQ(vec.Stats().peak_capacity, 1280);
+    ASSERT_EQ(vec.Stats().waste_histogram[0], 7) << "Every outgrown buffer was full";
+}
+
+TEST(VectorStatsTest, WasteBuckets) {
+    ASSERT_EQ(detail::WasteBucket(10, 10), 0);
+    ASSERT_EQ(detail::WasteBucket(5, 10), 5);
+    ASSERT_EQ(detail::WasteBucket(0, 10), VectorStats::WasteBuckets - 1);
+    ASSERT_EQ(detail::WasteBucket(1, 1000), VectorStats::WasteBuckets - 1);
+}
+
+TEST(VectorStatsTest, Recorder) {
+    ResetGlobalVectorStats();
+    {
+        detail::StatsRecorder<true> first;
+        first.OnReallocate(0, 10);
+        first.OnReallocate(40, 20);
+        first.OnRelease(15, 20);
+        ASSERT_EQ(first.Get().reallocations, 2);
+        ASSERT_EQ(first.Get().bytes_moved, 40);
+        ASSERT_EQ(first.Get().peak_capacity, 20);
+        ASSERT_EQ(first.Get().waste_histogram[2], 1);
+
+        detail::StatsRecorder<true> second;
+        second.OnReallocate(8, 100);
+        second.OnRelease(100, 100);
+        ASSERT_EQ(second.Get().reallocations, 1);
+    }
+    VectorStats global = GlobalVectorStats();
+    ASSERT_EQ(global.reallocations, 3);
+    ASSERT_EQ(global.bytes_moved, 48);
+    ASSERT_EQ(global.peak_capacity, 100);
+    ASSERT_EQ(global.waste_histogram[0], 1);
+    ASSERT_EQ(global.waste_histogram[2], 1);
+    ResetGlobalVectorStats();
+    ASSERT_EQ(GlobalVectorStats().reallocations, 0);
+}
+
+template <typename Vec>
+void CheckAlignedGrowth(size_t alignment) {
+    Vec vec;
+    for (int i = 0; i < 1000000; ++i) {
+        vec.PushBack(i);
+        if ((i & (i + 1)) == 0) {
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(vec.Data()) % alignment, 0) << "after " << i + 1 << " elements";
+        }
+    }
+    for (int i = 0; i < 1000000; ++i) {
+        ASSERT_EQ(vec[i], i);
+    }
+    Vec copy(vec);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(copy.Data()) % alignment, 0);
+    ASSERT_EQ(copy[999999], 999999);
+}
+
+TEST(AlignedVectorTest, Alignment) {
+    CheckAlignedGrowth<AlignedVector<int>>(64);
+    CheckAlignedGrowth<AlignedVector<int, 4096>>(4096);
+    CheckAlignedGrowth<HugePageVector<int>>(64);
+}
+
+TEST(AlignedVectorTest, HugePageBuffers) {
+    HugePageVector<char> vec;
+    vec.Resize(100, 'a');
+    ASSERT_FALSE(HugePageAllocator<char>::UsesHugePages(vec.Capacity()));
+
+    vec.Resize(detail::HugePageSize * 3 / 2, 'b');
+    ASSERT_TRUE(HugePageAllocator<char>::UsesHugePages(vec.Capacity()));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(vec.Data()) % detail::HugePageSize, 0);
+    ASSERT_EQ(vec[99], 'a');
+    ASSERT_EQ(vec.Back(), 'b');
+
+    vec.Erase(0, vec.Size() - 10);
+    HugePageVector<char> other(std::move(vec));
+    ASSERT_EQ(other.Size(), 10);
+}
+
+template <typename Vec, typename Make, typename Get>
+void CheckEraseIf(Make make, Get get) {
+    Vec vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.PushBack(make(i));
+    }
+    ASSERT_EQ(vec.EraseIf([&](auto& value) { return get(value) % 3 == 0; }), 334);
+    ASSERT_EQ(vec.Size(), 666);
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        int expected = i / 2 * 3 + 1 + i % 2;
+        ASSERT_EQ(get(vec[i]), expected);
+    }
+    ASSERT_EQ(vec.EraseIf([](auto&) { return false; }), 0);
+
+    int indices[] = {0, 0, 1, 5, 664, 665, 666, 10000};
+    ASSERT_EQ(vec.EraseIndices(std::begin(indices), std::end(indices)), 5);
+    ASSERT_EQ(vec.Size(), 661);
+    ASSERT_EQ(get(vec[0]), 4);
+    ASSERT_EQ(get(vec[3]), 10);
+
+    // A throwing predicate keeps every element it has not removed, in order
+    std::vector<int> expected;
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        if (i >= 99 || get(vec[i]) % 2 != 0) {
+            expected.push_back(get(vec[i]));
+        }
+    }
+    int calls = 0;
+    ASSERT_THROW(vec.EraseIf([&](auto& value) {
+        if (++calls == 100) {
+            throw std::runtime_error("predicate failed");
+        }
+        return get(value) % 2 == 0;
+    }),
+                 std::runtime_error);
+    ASSERT_EQ(vec.Size(), expected.size());
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        ASSERT_EQ(get(vec[i]), expected[i]);
+    }
+
+    size_t size = vec.Size();
+    ASSERT_EQ(vec.EraseIf([](auto&) { return true; }), size);
+    ASSERT_TRUE(vec.IsEmpty());
+}
+
+TEST(EraseIfTest, Trivial) {
+    CheckEraseIf<Vector<int>>([](int i) { return i; }, [](int value) { return value; });
+}
+
+TEST(EraseIfTest, Relocatable) {
+    CheckEraseIf<Vector<RelocatableObject>>([](int i) { return RelocatableObject(i); },
+                                            [](const RelocatableObject& value) { return *value.value; });
+}
+
+TEST(EraseIfTest, NonTrivial) {
+    CheckEraseIf<Vector<std::string>>([](int i) { return std::to_string(i); },
+                                      [](const std::string& value) { return std::stoi(value); });
+}
+
+template <typename T, typename Make>
+void CheckGapVectorAgainstModel(Make make) {
+    GapVector<T> vec;
+    std::vector<T> model;
+    std::mt19937 gen(42);
+    size_t cursor = 0;
+    for (int step = 0; step < 20000; ++step) {
+        // Mostly small cursor moves, sometimes a jump: the editor pattern
+        int action = gen() % 10;
+        if (action == 0) {
+            cursor = gen() % (model.size() + 1);
+        } else if (action < 7) {
+            vec.Insert(cursor, make(step));
+            model.insert(model.begin() + cursor, make(step));
+            ++cursor;
+        } else if (action < 9 && cursor > 0) {
+            size_t count = std::min<size_t>(cursor, 1 + gen() % 3);
+            vec.Erase(cursor - count, cursor);
+            model.erase(model.begin() + (cursor - count), model.begin() + cursor);
+            cursor -= count;
+        } else if (!model.empty()) {
+            size_t pos = gen() % model.size();
+            vec.Erase(pos, pos + 2);
+            model.erase(model.begin() + pos, model.begin() + std::min(pos + 2, model.size()));
+            cursor = std::min(cursor, model.size());
+        }
+        ASSERT_EQ(vec.Size(), model.size());
+    }
+    for (size_t i = 0; i < model.size(); ++i) {
+        ASSERT_EQ(vec[i], model[i]);
+    }
+}
+
+TEST(GapVectorTest, MatchesModel) {
+    CheckGapVectorAgainstModel<int>([](int i) { return i; });
+    CheckGapVectorAgainstModel<std::string>([](int i) { return std::string(20, 'a' + i % 26); });
+}
+
+TEST(GapVectorTest, Basics) {
+    GapVector<std::string> vec = {"b", "c"};
+    vec.Insert(0, "a");
+    vec.PushBack("d");
+    vec.EmplaceBack(vec[0]);
+    ASSERT_EQ(vec.Size(), 5);
+    ASSERT_EQ(vec.Front(), "a");
+    ASSERT_EQ(vec.Back(), "a");
+    vec.PopBack();
+    vec.Insert(2, "x");
+    ASSERT_EQ(vec.GapPosition(), 3);
+
+    GapVector<std::string> copy(vec);
+    vec.Erase(0, 100);
+    ASSERT_TRUE(vec.IsEmpty());
+    std::string expected[] = {"a", "b", "x", "c", "d"};
+    for (size_t i = 0; i < 5; ++i) {
+        ASSERT_EQ(copy[i], expected[i]);
+    }
+
+    GapVector<std::string> moved(std::move(copy));
+    ASSERT_EQ(moved.Size(), 5);
+    ASSERT_TRUE(copy.IsEmpty());
+    vec = moved;
+    std::swap(vec, moved);
+    ASSERT_EQ(vec[2], "x");
+
+    GapVector<int> filled(3, 7);
+    filled.Clear();
+    ASSERT_TRUE(filled.IsEmpty());
+    filled.PushBack(1);
+    ASSERT_EQ(filled.Back(), 1);
+}
+
+TEST(SoaVectorTest, ColumnsStayInSync) {
+    SoaVector<int, std::string, double> vec;
+    ASSERT_TRUE(vec.IsEmpty());
+    for (int i = 0; i < 100; ++i) {
+        vec.PushBack(i, std::to_string(i), i * 0.5);
+        ASSERT_EQ(vec.Size(), i + 1);
+        ASSERT_GE(vec.Capacity(), vec.Size());
+    }
+
+    auto ids = vec.Span<0>();
+    auto names = vec.Span<1>();
+    auto weights = vec.Span<2>();
+    ASSERT_EQ(ids.size(), 100);
+    ASSERT_EQ(names.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(ids[i], i);
+        ASSERT_EQ(names[i], std::to_string(i));
+        ASSERT_EQ(weights[i], i * 0.5);
+    }
+
+    auto [id, name, weight] = vec[42];
+    id = -1;
+    name = "changed";
+    ASSERT_EQ(vec.Span<0>()[42], -1);
+    ASSERT_EQ(std::get<1>(vec[42]), "changed");
+    ASSERT_EQ(weight, 21.0);
+
+    vec.PopBack();
+    ASSERT_EQ(vec.Size(), 99);
+    ASSERT_EQ(vec.Span<1>().size(), 99);
+
+    SoaVector<int, std::string, double> other;
+    other.PushBack(7, "seven", 7.0);
+    std::swap(vec, other);
+    ASSERT_EQ(vec.Size(), 1);
+    ASSERT_EQ(other.Size(), 99);
+    other.Clear();
+    ASSERT_TRUE(other.IsEmpty());
+}
+
+TEST(SoaVectorTest, ZipIterator) {
+    SoaVector<int, char> vec;
+    for (int i = 0; i < 26; ++i) {
+        vec.PushBack(i, 'a' + i);
+    }
+    int expected = 0;
+    for (auto it = vec.Begin(); it != vec.End(); ++it) {
+        auto [number, letter] = *it;
+        ASSERT_EQ(number, expected);
+        ASSERT_EQ(letter, 'a' + expected);
+        ++number;
+        ++expected;
+    }
+    ASSERT_EQ(vec.End() - vec.Begin(), 26);
+    ASSERT_EQ(std::get<0>(vec.Begin()[25]), 26);
+
+    auto found = std::find_if(vec.Begin(), vec.End(), [](auto record) { return std::get<1>(record) == 'k'; });
+    ASSERT_EQ(found - vec.Begin(), 10);
+    ASSERT_TRUE(found < vec.End());
+}
+
+TEST(SoaVectorTest, PushBackRollsBackOnThrow) {
+    SoaVector<int, ThrowingCopy, std::string> vec;
+    vec.Reserve(4);
+    ThrowingCopy::copies_left = 1;
+    vec.PushBack(1, ThrowingCopy(1), "one");
+    // The int column is already appended when moving ThrowingCopy (a copy) throws
+    ASSERT_THROW(vec.PushBack(2, ThrowingCopy(2), "two"), std::runtime_error);
+    ASSERT_EQ(vec.Size(), 1);
+    ASSERT_EQ(vec.Span<0>().size(), 1);
+    ASSERT_EQ(vec.Span<1>().size(), 1);
+    ASSERT_EQ(vec.Span<2>().size(), 1);
+    ThrowingCopy::copies_left = 1;
+    vec.PushBack(3, ThrowingCopy(3), "three");
+    ASSERT_EQ(vec.Span<0>()[1], 3);
+    ASSERT_EQ(vec.Span<1>()[1].value, 3);
+    ASSERT_EQ(vec.Span<2>()[1], "three");
+}
+
+class SnapshotFile {
+public:
+    SnapshotFile() : path_("vector_snapshot") {
+        fd_ = open(path_.Str().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    }
+
+    ~SnapshotFile() {
+        close(fd_);
+    }
+
+    int Rewind() {
+        lseek(fd_, 0, SEEK_SET);
+        return fd_;
+    }
+
+    // Overwrites one byte at offset
+    void Corrupt(off_t offset) {
+        char byte;
+        ASSERT_EQ(pread(fd_, &byte, 1, offset), 1);
+        byte ^= 1;
+        ASSERT_EQ(pwrite(fd_, &byte, 1, offset), 1);
+    }
+
+private:
+    TempPath path_;
+    int fd_;
+};
+
+TEST(VectorIoTest, RoundTrip) {
+    Vector<int64_t> vec;
+    for (int64_t i = 0; i < 10007; ++i) {
+        vec.PushBack(i * i);
+    }
+    SnapshotFile file;
+    Serialize(vec, file.Rewind());
+
+    Vector<int64_t> loaded = {1, 2, 3};
+    Load(file.Rewind(), loaded);
+    ASSERT_EQ(loaded.Size(), vec.Size());
+    ASSERT_TRUE(std::equal(vec.Data(), vec.Data() + vec.Size(), loaded.Data()));
+
+    VectorView<int64_t> view(file.Rewind());
+    ASSERT_EQ(view.Size(), vec.Size());
+    ASSERT_EQ(view[10006], 10006 * 10006);
+    ASSERT_TRUE(std::equal(vec.Data(), vec.Data() + vec.Size(), view.Data()));
+
+    VectorView<int64_t> moved(std::move(view));
+    ASSERT_TRUE(view.IsEmpty());
+    ASSERT_EQ(view.Data(), nullptr);
+    ASSERT_EQ(moved[1], 1);
+}
+
+TEST(VectorIoTest, ConsecutiveSnapshots) {
+    Vector<int> empty;
+    Vector<int> small = {4, 5, 6};
+    SnapshotFile file;
+    int fd = file.Rewind();
+    Serialize(empty, fd);
+    Serialize(small, fd);
+
+    fd = file.Rewind();
+    Vector<int> first = {1};
+    Load(fd, first);
+    ASSERT_TRUE(first.IsEmpty());
+    Vector<int> second;
+    Load(fd, second);
+    ASSERT_EQ(second.Size(), 3);
+    ASSERT_EQ(second[2], 6);
+}
+
+TEST(VectorIoTest, RejectsBadSnapshots) {
+    Vector<int32_t> vec(1000, 7);
+    SnapshotFile file;
+    Serialize(vec, file.Rewind());
+
+    Vector<int64_t> wrong_type;
+    ASSERT_THROW(Load(file.Rewind(), wrong_type), SerializationException);
+    ASSERT_THROW(VectorView<int64_t>(file.Rewind()), SerializationException);
+
+    file.Corrupt(sizeof(detail::SnapshotHeader) + 123);
+    Vector<int32_t> loaded = {1, 2};
+    ASSERT_THROW(Load(file.Rewind(), loaded), SerializationException);
+    ASSERT_TRUE(loaded.IsEmpty());
+    ASSERT_THROW(VectorView<int32_t>(file.Rewind()), SerializationException);
+    VectorView<int32_t> unchecked(file.Rewind(), ChecksumCheck::Skip);
+    ASSERT_EQ(unchecked.Size(), 1000);
+    Load(file.Rewind(), loaded, ChecksumCheck::Skip);
+    ASSERT_EQ(loaded.Size(), 1000);
+
+    ASSERT_EQ(ftruncate(file.Rewind(), sizeof(detail::SnapshotHeader) + 100), 0);
+    ASSERT_THROW(Load(file.Rewind(), loaded, ChecksumCheck::Skip), SerializationException);
+    ASSERT_THROW(VectorView<int32_t>(file.Rewind(), ChecksumCheck::Skip), SerializationException);
+
+    file.Corrupt(0);
+    ASSERT_THROW(Load(file.Rewind(), loaded), SerializationException);
+}
+
+TEST(VectorIoTest, HugeSizeFailsBeforeAllocating) {
+    // A header that claims 2^60 elements, followed by no elements at all
+    Vector<int64_t> empty;
+    SnapshotFile file;
+    Serialize(empty, file.Rewind());
+    detail::SnapshotHeader header;
+    ASSERT_EQ(read(file.Rewind(), &header, sizeof(header)), static_cast<ssize_t>(sizeof(header)));
+    header.size = uint64_t(1) << 60;
+    ASSERT_EQ(pwrite(file.Rewind(), &header, sizeof(header), 0), static_cast<ssize_t>(sizeof(header)));
+    Vector<int64_t> loaded;
+    size_t capacity = loaded.Capacity();
+    ASSERT_THROW(Load(file.Rewind(), loaded), SerializationException);
+    ASSERT_EQ(loaded.Capacity(), capacity) << "The size must be checked against the file first";
+
+    // A pipe has no length: the buffer may only grow as elements arrive
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    int64_t element = 42;
+    ASSERT_EQ(write(fds[1], &header, sizeof(header)), static_cast<ssize_t>(sizeof(header)));
+    ASSERT_EQ(write(fds[1], &element, sizeof(element)), static_cast<ssize_t>(sizeof(element)));
+    close(fds[1]);
+    ASSERT_THROW(Load(fds[0], loaded), SerializationException);
+    close(fds[0]);
+    ASSERT_TRUE(loaded.IsEmpty());
+    ASSERT_LE(loaded.Capacity(), size_t(1) << 20);
+
+    // A well-formed snapshot still loads through a pipe, chunk by chunk
+    Vector<int64_t> vec;
+    for (int64_t i = 0; i < 300000; ++i) {
+        vec.PushBack(i);
+    }
+    ASSERT_EQ(pipe(fds), 0);
+    std::thread writer([&] {
+        Serialize(vec, fds[1]);
+        close(fds[1]);
+    });
+    Load(fds[0], loaded);
+    writer.join();
+    close(fds[0]);
+    ASSERT_EQ(loaded.Size(), vec.Size());
+    ASSERT_TRUE(std::equal(vec.Data(), vec.Data() + vec.Size(), loaded.Data()));
+}
+
+TEST(CowVectorTest, CopiesShareUntilModified) {
+    CowVector<std::string> vec = {"a", "b", "c"};
+    ASSERT_FALSE(vec.IsShared());
+    const CowVector<std::string> snapshot = vec;
+    ASSERT_TRUE(vec.IsShared());
+    ASSERT_EQ(snapshot.Data(), vec.Data());
+
+    vec.PushBack("d");
+    ASSERT_FALSE(vec.IsShared());
+    ASSERT_FALSE(snapshot.IsShared());
+    ASSERT_NE(snapshot.Data(), vec.Data());
+    ASSERT_EQ(snapshot.Size(), 3);
+    ASSERT_EQ(vec.Size(), 4);
+    ASSERT_EQ(snapshot.Back(), "c");
+    ASSERT_EQ(vec.Back(), "d");
+
+    // Exclusive again: modified in place
+    const std::string* data = vec.Data();
+    vec[0] = "x";
+    vec.Erase(1, 2);
+    ASSERT_EQ(vec.Data(), data);
+    ASSERT_EQ(vec[0], "x");
+    ASSERT_EQ(snapshot[0], "a");
+    ASSERT_EQ(snapshot[1], "b");
+}
+
+TEST(CowVectorTest, EveryModificationDetaches) {
+    CowVector<int> vec(5, 1);
+    auto check = [&vec](auto modify) {
+        CowVector<int> snapshot(vec);
+        modify(vec);
+        ASSERT_EQ(snapshot.Size(), 5);
+        ASSERT_TRUE(std::all_of(snapshot.Data(), snapshot.Data() + 5, [](int x) { return x == 1; }));
+        ASSERT_FALSE(snapshot.IsShared());
+        vec = CowVector<int>(5, 1);
+    };
+    check([](CowVector<int>& v) { v[2] = 0; });
+    check([](CowVector<int>& v) { v.Insert(0, 0); });
+    check([](CowVector<int>& v) { v.Erase(0, 2); });
+    check([](CowVector<int>& v) { v.EmplaceBack(0); });
+    check([](CowVector<int>& v) { v.PopBack(); });
+    check([](CowVector<int>& v) { v.Resize(10, 0); });
+    check([](CowVector<int>& v) { v.Reserve(100); });
+    check([](CowVector<int>& v) { v.Clear(); });
+
+    CowVector<int> snapshot(vec);
+    vec.Clear();
+    ASSERT_TRUE(vec.IsEmpty());
+    ASSERT_EQ(vec.Data(), nullptr);
+    vec.PushBack(7);
+    ASSERT_EQ(vec[0], 7);
+    ASSERT_EQ(snapshot.Size(), 5);
+}
+
+TEST(CowVectorTest, AdoptsVectorAndMoves) {
+    Vector<int> source = {1, 2, 3};
+    int* data = source.Data();
+    CowVector<int> vec(std::move(source));
+    ASSERT_EQ(vec.Data(), data);
+
+    CowVector<int> moved(std::move(vec));
+    ASSERT_TRUE(vec.IsEmpty());
+    ASSERT_EQ(moved.Size(), 3);
+    CowVector<int> other;
+    other = moved;
+    ASSERT_TRUE(other.IsShared());
+    std::swap(vec, other);
+    ASSERT_EQ(vec.Front(), 1);
+    vec = std::move(moved);
+    ASSERT_FALSE(vec.IsShared());
+}
+
+TEST(CowVectorTest, SnapshotsAcrossThreads) {
+    CowVector<int64_t> vec;
+    for (int64_t i = 0; i < 1000; ++i) {
+        vec.PushBack(i);
+    }
+    std::vector<std::thread> readers;
+    std::atomic<int> bad_sums = 0;
+    for (int round = 0; round < 50; ++round) {
+        // The reader owns its copy; the writer keeps modifying its own
+        readers.emplace_back([snapshot = vec, &bad_sums] {
+            int64_t sum = 0;
+            for (size_t i = 0; i < snapshot.Size(); ++i) {
+                sum += snapshot[i];
+            }
+            int64_t n = snapshot.Size();
+            if (sum != n * (n - 1) / 2) {
+                ++bad_sums;
+            }
+        });
+        vec.PushBack(vec.Size());
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(bad_sums, 0);
+    ASSERT_FALSE(vec.IsShared());
+}
 
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Fixed set of worker threads for data-parallel loops over huge buffers.
+// The thread that calls ParallelFor works on the tasks too, so a pool of
+// threads_count has threads_count - 1 workers.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads_count = std::max(1u, std::thread::hardware_concurrency()))
+        : workers_count_(std::max<size_t>(threads_count, 1) - 1),
+          workers_(std::make_unique<std::thread[]>(workers_count_)) {
+        for (size_t i = 0; i < workers_count_; ++i) {
+            workers_[i] = std::thread([this] { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool& other) = delete;
+
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    size_t ThreadCount() const noexcept {
+        return workers_count_ + 1;
+    }
+
+    // Runs task(0), ..., task(count - 1) and returns once all of them finished.
+    // If some tasks throw, the others still run and the first exception is rethrown.
+    // Called from inside a task, or while another loop is running, it runs serially.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& task) {
+        // Checked before try_lock: a task running on the submitting thread must
+        // not try to lock the submit_mutex_ that thread already holds
+        if (in_parallel_for || workers_count_ == 0) {
+            RunSerially(count, task);
+            return;
+        }
+        std::unique_lock submit(submit_mutex_, std::try_to_lock);
+        if (!submit.owns_lock()) {
+            RunSerially(count, task);
+            return;
+        }
+        in_parallel_for = true;
+        struct LeaveParallelFor {
+            ~LeaveParallelFor() {
+                in_parallel_for = false;
+            }
+        } leave;
+
+        Job job(task, count);
+        {
+            std::lock_guard guard(mutex_);
+            job_ = &job;
+            ++generation_;
+        }
+        wake_.notify_all();
+        RunTasks(job);
+        {
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [&] { return job.finished == count && active_ == 0; });
+            job_ = nullptr;
+        }
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < workers_count_; ++i) {
+            workers_[i].join();
+        }
+    }
+
+    // Shared pool with a thread per core, started on first use
+    static ThreadPool& Default() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    struct Job {
+        Job(const std::function<void(size_t)>& task, size_t count) : task(task), count(count) {
+        }
+
+        const std::function<void(size_t)>& task;
+        const size_t count;
+        std::atomic<size_t> next = 0;
+        std::atomic<size_t> finished = 0;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    static void RunSerially(size_t count, const std::function<void(size_t)>& task) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+    }
+
+    void WorkerLoop() {
+        in_parallel_for = true;
+        uint64_t seen_generation = 0;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stop_ || (job_ && generation_ != seen_generation); });
+            if (stop_) {
+                return;
+            }
+            seen_generation = generation_;
+            Job& job = *job_;
+            ++active_;
+            lock.unlock();
+            RunTasks(job);
+            lock.lock();
+            --active_;
+            done_.notify_all();
+        }
+    }
+
+    void RunTasks(Job& job) {
+        for (size_t i = job.next++; i < job.count; i = job.next++) {
+            try {
+                job.task(i);
+            } catch (...) {
+                std::lock_guard guard(job.error_mutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+            }
+            if (++job.finished == job.count) {
+                // Lock so the notification cannot slip in between the waiter's check and its sleep
+                std::lock_guard guard(mutex_);
+                done_.notify_all();
+            }
+        }
+    }
+
+    // Set for workers and for a thread while it submits a loop: tasks they run go serial
+    inline static thread_local bool in_parallel_for = false;
+
+    const size_t workers_count_;
+    std::unique_ptr<std::thread[]> workers_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Job* job_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t active_ = 0;
+    bool stop_ = false;
+};
+
+namespace detail {
+
+inline std::atomic<size_t> parallel_threshold = std::numeric_limits<size_t>::max();
+inline std::atomic<ThreadPool*> parallel_pool = nullptr;
+
+}  // namespace detail
+
+// Vector splits construction, copying and filling of at least `count` elements
+// across the parallel pool. The default, SIZE_MAX, keeps all of it on the calling thread.
+inline void SetParallelThreshold(size_t count) noexcept {
+    detail::parallel_threshold = count;
+}
+
+inline size_t ParallelThreshold() noexcept {
+    return detail::parallel_threshold;
+}
+
+// nullptr switches back to ThreadPool::Default()
+inline void SetParallelPool(ThreadPool* pool) noexcept {
+    detail::parallel_pool = pool;
+}
+
+inline ThreadPool& ParallelPool() {
+    ThreadPool* pool = detail::parallel_pool;
+    return pool ? *pool : ThreadPool::Default();
+}
@@ -1,117 +1,718 @@
 #include "vector.hpp"
 
-template <typename T>
-Vector<T>::Vector() {
-    // Not Implemented
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace detail {
+
+// Anonymous page mappings for HugeBufferGrowth; sizes are rounded up to whole pages
+inline size_t RoundUpToPages(size_t bytes) noexcept {
+#if defined(__linux__)
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+#else
+    const size_t page_size = 4096;
+#endif
+    return (bytes + page_size - 1) / page_size * page_size;
+}
+
+inline void* MapPages(size_t bytes) {
+#if defined(__linux__)
+    void* ptr = mmap(nullptr, RoundUpToPages(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr != MAP_FAILED) {
+        return ptr;
+    }
+#endif
+    throw std::bad_alloc();
+}
+
+inline void* RemapPages(void* ptr, size_t old_bytes, size_t new_bytes) {
+#if defined(__linux__)
+    void* new_ptr = mremap(ptr, RoundUpToPages(old_bytes), RoundUpToPages(new_bytes), MREMAP_MAYMOVE);
+    if (new_ptr != MAP_FAILED) {
+        return new_ptr;
+    }
+#endif
+    throw std::bad_alloc();
+}
+
+inline void UnmapPages(void* ptr, size_t bytes) noexcept {
+#if defined(__linux__)
+    munmap(ptr, RoundUpToPages(bytes));
+#endif
+}
+
+}  // namespace detail
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector() : Vector(Allocator()) {
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector(const Allocator& alloc)
+    : data_(InlineData()), size_(0), capacity_(InlineCapacity), alloc_(alloc) {
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector(size_t count, const T& value, const Allocator& alloc)
+    : Vector(alloc) {
+    Reserve(count);
+    ConstructFill(data_, count, value);
+    size_ = count;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector(size_t count, DefaultInitTag, const Allocator& alloc)
+    : Vector(alloc) {
+    ResizeDefaultInit(count);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector(const Vector& other)
+    : Vector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector(const Vector& other, const Allocator& alloc)
+    : Vector(alloc) {
+    Reserve(other.size_);
+    ConstructFrom(other.data_, other.size_, data_);
+    size_ = other.size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+auto Vector<T, Allocator, GrowthPolicy, InlineCapacity>::operator=(const Vector& other) -> Vector& {
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+        if (alloc_ != other.alloc_) {
+            // Our buffer must go back to the allocator that produced it
+            Reset();
+        }
+        alloc_ = other.alloc_;
+    }
+    Vector copy(other, alloc_);
+    SwapStorage(copy);
+    return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+auto Vector<T, Allocator, GrowthPolicy, InlineCapacity>::operator=(Vector&& other) -> Vector& {
+    if (this == &other) {
+        return *this;
+    }
+    Reset();
+    if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+        alloc_ = std::move(other.alloc_);
+    } else if (!AllocTraits::is_always_equal::value && alloc_ != other.alloc_) {
+        // Foreign buffer cannot be adopted: move the elements into our own storage
+        Reserve(other.size_);
+        ConstructFrom(std::make_move_iterator(other.data_), other.size_, data_);
+        size_ = other.size_;
+        other.Clear();
+        return *this;
+    }
+    StealFrom(other);
+    return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector(Vector&& other) noexcept(NothrowSteal)
+    : Vector(std::move(other.alloc_)) {
+    StealFrom(other);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Vector(std::initializer_list<T> init, const Allocator& alloc)
+    : Vector(alloc) {
+    Reserve(NextCapacity(init.size()));
+    ConstructFrom(init.begin(), init.size(), data_);
+    size_ = init.size();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+T& Vector<T, Allocator, GrowthPolicy, InlineCapacity>::operator[](size_t pos) {
+    return data_[pos];
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+T& Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Front() const noexcept {
+    return data_[0];
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+bool Vector<T, Allocator, GrowthPolicy, InlineCapacity>::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+T& Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Back() const noexcept {
+    return data_[size_ - 1];
 }
 
-template <typename T>
-Vector<T>::Vector(size_t /*count*/, const T& /*value*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+T* Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Data() const noexcept {
+    return data_;
 }
 
-template <typename T>
-Vector<T>::Vector(const Vector& /*other*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Allocator Vector<T, Allocator, GrowthPolicy, InlineCapacity>::GetAllocator() const {
+    return alloc_;
 }
 
-template <typename T>
-Vector<T>& Vector<T>::operator=(const Vector& /*other*/) {
-    std::abort(); // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+size_t Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Size() const noexcept {
+    return size_;
 }
 
-template <typename T>
-Vector<T>& Vector<T>::operator=(Vector&& /*other*/) {
-    std::abort(); // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+size_t Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Capacity() const noexcept {
+    return capacity_;
 }
 
-template <typename T>
-Vector<T>::Vector(Vector&& /*other*/) noexcept {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+bool Vector<T, Allocator, GrowthPolicy, InlineCapacity>::IsInline() const noexcept {
+    return data_ == inline_.Data();
 }
 
-template <typename T>
-Vector<T>::Vector(std::initializer_list<T> /*init*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+bool Vector<T, Allocator, GrowthPolicy, InlineCapacity>::IsMapped() const noexcept {
+    return !IsInline() && IsMappedCapacity(capacity_);
 }
 
-template <typename T>
-T& Vector<T>::operator[](size_t /*pos*/) {
-    std::abort();  // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+VectorStats Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Stats() const noexcept {
+    return stats_.Get();
 }
 
-template <typename T>
-T& Vector<T>::Front() const noexcept {
-    std::abort();  // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Reserve(size_t new_cap) {
+    if (new_cap > capacity_) {
+        Reallocate(new_cap);
+    }
 }
 
-template <typename T>
-bool Vector<T>::IsEmpty() const noexcept {
-    std::abort();  // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Clear() noexcept {
+    Destroy(data_, data_ + size_);
+    size_ = 0;
 }
 
-template <typename T>
-T& Vector<T>::Back() const noexcept {
-    std::abort();  // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Insert(size_t pos, T value) {
+    pos = std::min(pos, size_);
+    if (pos == size_) {
+        EmplaceBack(std::move(value));
+        return;
+    }
+    Reserve(NextCapacity(size_ + 1));
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        // Shift the tail as raw bytes, then build the new element in the hole
+        std::memmove(static_cast<void*>(data_ + pos + 1), data_ + pos, (size_ - pos) * sizeof(T));
+        try {
+            Construct(data_ + pos, std::move(value));
+        } catch (...) {
+            std::memmove(static_cast<void*>(data_ + pos), data_ + pos + 1, (size_ - pos) * sizeof(T));
+            throw;
+        }
+    } else {
+        Construct(data_ + size_, std::move(data_[size_ - 1]));
+        std::move_backward(data_ + pos, data_ + size_ - 1, data_ + size_);
+        data_[pos] = std::move(value);
+    }
+    ++size_;
 }
 
-template <typename T>
-T* Vector<T>::Data() const noexcept {
-    std::abort();  // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Erase(size_t begin_pos, size_t end_pos) {
+    end_pos = std::min(end_pos, size_);
+    if (begin_pos >= end_pos) {
+        return;
+    }
+    size_t new_size = size_ - (end_pos - begin_pos);
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        Destroy(data_ + begin_pos, data_ + end_pos);
+        std::memmove(static_cast<void*>(data_ + begin_pos), data_ + end_pos, (size_ - end_pos) * sizeof(T));
+    } else {
+        std::move(data_ + end_pos, data_ + size_, data_ + begin_pos);
+        Destroy(data_ + new_size, data_ + size_);
+    }
+    size_ = new_size;
 }
 
-template <typename T>
-size_t Vector<T>::Size() const noexcept {
-    std::abort();  // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <typename Predicate>
+size_t Vector<T, Allocator, GrowthPolicy, InlineCapacity>::EraseIf(Predicate pred) {
+    return RemoveWhere([&](size_t, T& value) { return static_cast<bool>(pred(value)); });
 }
 
-template <typename T>
-size_t Vector<T>::Capacity() const noexcept {
-    std::abort();  // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <typename InputIt>
+size_t Vector<T, Allocator, GrowthPolicy, InlineCapacity>::EraseIndices(InputIt first, InputIt last) {
+    return RemoveWhere([&](size_t pos, T&) {
+        while (first != last && static_cast<size_t>(*first) < pos) {
+            ++first;
+        }
+        return first != last && static_cast<size_t>(*first) == pos;
+    });
 }
 
-template <typename T>
-void Vector<T>::Reserve(size_t /*new_cap*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::PushBack(T value) {
+    EmplaceBack(std::move(value));
 }
 
-template <typename T>
-void Vector<T>::Clear() noexcept {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <class... Args>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::EmplaceBack(Args&&... args) {
+    if (size_ < capacity_) {
+        Construct(data_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return;
+    }
+    size_t new_cap = NextCapacity(size_ + 1);
+    if constexpr (CanMapPages) {
+        if (IsMapped()) {
+            // mremap may move the pages args point into: build the element first
+            T value(std::forward<Args>(args)...);
+            Reallocate(new_cap);
+            Construct(data_ + size_, std::move(value));
+            ++size_;
+            return;
+        }
+    }
+    // args may refer to our own elements, so build the new one before relocating the rest
+    T* new_data = Allocate(new_cap);
+    try {
+        Construct(new_data + size_, std::forward<Args>(args)...);
+    } catch (...) {
+        Deallocate(new_data, new_cap);
+        throw;
+    }
+    try {
+        Relocate(data_, size_, new_data);
+    } catch (...) {
+        Destroy(new_data + size_, new_data + size_ + 1);
+        Deallocate(new_data, new_cap);
+        throw;
+    }
+    stats_.OnReallocate(size_ * sizeof(T), new_cap);
+    if (!IsInline()) {
+        stats_.OnRelease(size_, capacity_);
+        Deallocate(data_, capacity_);
+    }
+    data_ = new_data;
+    capacity_ = new_cap;
+    ++size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::PopBack() {
+    Destroy(data_ + size_ - 1, data_ + size_);
+    --size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Resize(size_t count, const T& value) {
+    if (count <= size_) {
+        Destroy(data_ + count, data_ + size_);
+        size_ = count;
+        return;
+    }
+    if (count > capacity_ && std::less_equal<>()(data_, &value) && std::less<>()(&value, data_ + size_)) {
+        // value is one of our elements: copy it before reallocation frees it
+        T copy(value);
+        Reserve(count);
+        ConstructFill(data_ + size_, count - size_, copy);
+    } else {
+        Reserve(count);
+        ConstructFill(data_ + size_, count - size_, value);
+    }
+    size_ = count;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <typename InputIt>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::AppendRange(InputIt first, InputIt last) {
+    if constexpr (std::forward_iterator<InputIt>) {
+        size_t count = std::distance(first, last);
+        if (count > capacity_ - size_) {
+            if constexpr (std::is_pointer_v<InputIt>) {
+                // Appending a piece of ourselves: re-aim the range after reallocation
+                if (std::less_equal<>()(data_, first) && std::less<>()(first, data_ + size_)) {
+                    size_t offset = first - data_;
+                    Reserve(NextCapacity(size_ + count));
+                    first = data_ + offset;
+                } else {
+                    Reserve(NextCapacity(size_ + count));
+                }
+            } else {
+                Reserve(NextCapacity(size_ + count));
+            }
+        }
+        ConstructFrom(first, count, data_ + size_);
+        size_ += count;
+    } else {
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::ResizeDefaultInit(size_t count) {
+    if (count <= size_) {
+        Destroy(data_ + count, data_ + size_);
+        size_ = count;
+        return;
+    }
+    Reserve(count);
+    if constexpr (!std::is_trivially_default_constructible_v<T>) {
+        size_t constructed = size_;
+        try {
+            for (; constructed < count; ++constructed) {
+                ::new (static_cast<void*>(data_ + constructed)) T;
+            }
+        } catch (...) {
+            Destroy(data_ + size_, data_ + constructed);
+            throw;
+        }
+    }
+    size_ = count;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::ResizeUninitialized(size_t count) {
+    static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                  "ResizeUninitialized is only for trivial types, use ResizeDefaultInit");
+    ResizeDefaultInit(count);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Swap(Vector& other) {
+    if (this == &other) {
+        return;
+    }
+    if constexpr (AllocTraits::propagate_on_container_swap::value) {
+        std::swap(alloc_, other.alloc_);
+    }
+    SwapStorage(other);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+Vector<T, Allocator, GrowthPolicy, InlineCapacity>::~Vector() {
+    Reset();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+T* Vector<T, Allocator, GrowthPolicy, InlineCapacity>::InlineData() noexcept {
+    return inline_.Data();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+size_t Vector<T, Allocator, GrowthPolicy, InlineCapacity>::NextCapacity(size_t min_cap) const noexcept {
+    if (min_cap <= capacity_) {
+        return capacity_;
+    }
+    return std::max(GrowthPolicy::NextCapacity(capacity_, min_cap), InitialCapacity);
 }
 
-template <typename T>
-void Vector<T>::Insert(size_t /*pos*/, T /*value*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+bool Vector<T, Allocator, GrowthPolicy, InlineCapacity>::IsMappedCapacity(size_t capacity) noexcept {
+    if constexpr (CanMapPages) {
+        return capacity * sizeof(T) >= GrowthPolicy::MapThresholdBytes;
+    } else {
+        return false;
+    }
 }
 
-template <typename T>
-void Vector<T>::Erase(size_t /*begin_pos*/, size_t /*end_pos*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+T* Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Allocate(size_t count) {
+    if (IsMappedCapacity(count)) {
+        return static_cast<T*>(detail::MapPages(count * sizeof(T)));
+    }
+    return AllocTraits::allocate(alloc_, count);
 }
 
-template <typename T>
-void Vector<T>::PushBack(T /*value*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Deallocate(T* data, size_t count) noexcept {
+    if (IsMappedCapacity(count)) {
+        detail::UnmapPages(data, count * sizeof(T));
+        return;
+    }
+    AllocTraits::deallocate(alloc_, data, count);
 }
 
-template <typename T>
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
 template <class... Args>
-void Vector<T>::EmplaceBack(Args&&... /*args*/) {
-    // Not Implemented
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Construct(T* ptr, Args&&... args) {
+    AllocTraits::construct(alloc_, ptr, std::forward<Args>(args)...);
 }
 
-template <typename T>
-void Vector<T>::PopBack() {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Destroy(T* first, T* last) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (; first != last; ++first) {
+            AllocTraits::destroy(alloc_, first);
+        }
+    }
 }
 
-template <typename T>
-void Vector<T>::Resize(size_t /*count*/, const T& /*value*/) {
-    // Not Implemented
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <typename ConstructChunk>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::ConstructInChunks(T* to, size_t count,
+                                                                           ConstructChunk construct_chunk) {
+    if (!CanConstructInParallel || count < ParallelThreshold()) {
+        construct_chunk(0, count);
+        return;
+    }
+    ThreadPool& pool = ParallelPool();
+    // A few chunks per thread even out threads that start late or run on a busy core
+    size_t chunks = std::min(count, pool.ThreadCount() * 4);
+    size_t chunk_size = (count + chunks - 1) / chunks;
+    chunks = (count + chunk_size - 1) / chunk_size;
+    auto built = std::make_unique<bool[]>(chunks);
+    try {
+        pool.ParallelFor(chunks, [&](size_t chunk) {
+            size_t begin = chunk * chunk_size;
+            construct_chunk(begin, std::min(count, begin + chunk_size));
+            built[chunk] = true;
+        });
+    } catch (...) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (built[chunk]) {
+                size_t begin = chunk * chunk_size;
+                Destroy(to + begin, to + std::min(count, begin + chunk_size));
+            }
+        }
+        throw;
+    }
 }
 
-template <typename T>
-Vector<T>::~Vector() {
-    // Not Implemented
-}
\ No newline at end of file
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <typename InputIt>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::ConstructFrom(InputIt first, size_t count, T* to) {
+    if constexpr (std::random_access_iterator<InputIt>) {
+        ConstructInChunks(to, count, [&](size_t begin, size_t end) {
+            ConstructChunkFrom(first + begin, end - begin, to + begin);
+        });
+    } else {
+        ConstructChunkFrom(first, count, to);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <typename InputIt>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::ConstructChunkFrom(InputIt first, size_t count, T* to) {
+    if constexpr (std::is_pointer_v<InputIt> && std::is_same_v<std::remove_cv_t<std::iter_value_t<InputIt>>, T> &&
+                  std::is_trivially_copyable_v<T> && std::is_same_v<Allocator, std::allocator<T>>) {
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(to), first, count * sizeof(T));
+        }
+    } else {
+        size_t constructed = 0;
+        try {
+            for (; constructed < count; ++constructed, ++first) {
+                Construct(to + constructed, *first);
+            }
+        } catch (...) {
+            Destroy(to, to + constructed);
+            throw;
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::ConstructFill(T* to, size_t count, const T& value) {
+    ConstructInChunks(to, count, [&](size_t begin, size_t end) { ConstructChunkFill(to + begin, end - begin, value); });
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::ConstructChunkFill(T* to, size_t count, const T& value) {
+    size_t constructed = 0;
+    try {
+        for (; constructed < count; ++constructed) {
+            Construct(to + constructed, value);
+        }
+    } catch (...) {
+        Destroy(to, to + constructed);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+template <typename IsRemoved>
+size_t Vector<T, Allocator, GrowthPolicy, InlineCapacity>::RemoveWhere(IsRemoved is_removed) {
+    size_t old_size = size_;
+    size_t write = 0;
+    size_t read = 0;
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        // Removed elements are destroyed in place and every run of survivors is moved with one memmove.
+        // [pending, read) is the current run, [write, pending) holds no objects.
+        size_t pending = 0;
+        auto flush_run = [&] {
+            if (write != pending) {
+                std::memmove(static_cast<void*>(data_ + write), data_ + pending, (read - pending) * sizeof(T));
+            }
+            write += read - pending;
+        };
+        try {
+            for (; read < size_; ++read) {
+                if (is_removed(read, data_[read])) {
+                    flush_run();
+                    Destroy(data_ + read, data_ + read + 1);
+                    pending = read + 1;
+                }
+            }
+        } catch (...) {
+            // Keep the current run and the unvisited tail
+            read = size_;
+            flush_run();
+            size_ = write;
+            throw;
+        }
+        flush_run();
+        size_ = write;
+    } else {
+        try {
+            for (; read < size_; ++read) {
+                if (!is_removed(read, data_[read])) {
+                    if (write != read) {
+                        data_[write] = std::move(data_[read]);
+                    }
+                    ++write;
+                }
+            }
+        } catch (...) {
+            // [write, read) holds removed or moved-from elements
+            Erase(write, read);
+            throw;
+        }
+        Destroy(data_ + write, data_ + size_);
+        size_ = write;
+    }
+    return old_size - size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Relocate(T* from, size_t count, T* to) {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+        }
+    } else {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            ConstructFrom(std::make_move_iterator(from), count, to);
+        } else {
+            ConstructFrom(from, count, to);
+        }
+        Destroy(from, from + count);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Reallocate(size_t new_cap) {
+    if (IsMapped()) {
+        // Grow in place: no element is copied, the kernel remaps the pages
+        data_ = static_cast<T*>(detail::RemapPages(data_, capacity_ * sizeof(T), new_cap * sizeof(T)));
+        stats_.OnReallocate(0, new_cap);
+        capacity_ = new_cap;
+        return;
+    }
+    T* new_data = Allocate(new_cap);
+    try {
+        Relocate(data_, size_, new_data);
+    } catch (...) {
+        Deallocate(new_data, new_cap);
+        throw;
+    }
+    stats_.OnReallocate(size_ * sizeof(T), new_cap);
+    if (!IsInline()) {
+        stats_.OnRelease(size_, capacity_);
+        Deallocate(data_, capacity_);
+    }
+    data_ = new_data;
+    capacity_ = new_cap;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::Reset() noexcept {
+    size_t size = size_;
+    Clear();
+    if (!IsInline()) {
+        stats_.OnRelease(size, capacity_);
+        Deallocate(data_, capacity_);
+    }
+    data_ = InlineData();
+    capacity_ = InlineCapacity;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::StealFrom(Vector& other) noexcept(NothrowSteal) {
+    if (!other.IsInline()) {
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = other.InlineData();
+        other.size_ = 0;
+        other.capacity_ = InlineCapacity;
+        return;
+    }
+    // Inline elements cannot be stolen, only relocated into our own inline buffer.
+    // Without inline capacity the inline state is an empty vector: nothing to move.
+    if constexpr (InlineCapacity > 0) {
+        Relocate(other.data_, other.size_, data_);
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Vector<T, Allocator, GrowthPolicy, InlineCapacity>::SwapStorage(Vector& other) {
+    if (!IsInline() && !other.IsInline()) {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        return;
+    }
+    if (IsInline() && other.IsInline()) {
+        // Both fit into InlineCapacity: swap the common prefix, move the rest across
+        Vector& longer = size_ >= other.size_ ? *this : other;
+        Vector& shorter = size_ >= other.size_ ? other : *this;
+        std::swap_ranges(shorter.data_, shorter.data_ + shorter.size_, longer.data_);
+        shorter.Relocate(longer.data_ + shorter.size_, longer.size_ - shorter.size_, shorter.data_ + shorter.size_);
+        std::swap(size_, other.size_);
+        return;
+    }
+    // Exactly one side is on the heap: it hands its buffer over, the inline side moves its elements
+    Vector& heap_side = IsInline() ? other : *this;
+    Vector& inline_side = IsInline() ? *this : other;
+    T* heap_data = heap_side.data_;
+    size_t heap_size = heap_side.size_;
+    size_t heap_capacity = heap_side.capacity_;
+    heap_side.data_ = heap_side.InlineData();
+    heap_side.size_ = 0;
+    heap_side.capacity_ = InlineCapacity;
+    try {
+        heap_side.StealFrom(inline_side);
+    } catch (...) {
+        // The inline elements stayed where they were: give the heap side its buffer back
+        heap_side.data_ = heap_data;
+        heap_side.size_ = heap_size;
+        heap_side.capacity_ = heap_capacity;
+        throw;
+    }
+    inline_side.data_ = heap_data;
+    inline_side.size_ = heap_size;
+    inline_side.capacity_ = heap_capacity;
+}
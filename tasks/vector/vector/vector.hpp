@@ -1,24 +1,136 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
+#include "aligned_allocator.hpp"
+#include "thread_pool.hpp"
+#include "vector_stats.hpp"
+
+// A type is trivially relocatable if moving an object to a new address and
+// destroying the old one is equivalent to copying its bytes. Vector then moves
+// such elements with memcpy/memmove instead of one by one.
+//
+// Trivially copyable types are detected automatically. Other types (handles
+// owning a heap pointer, for example) may opt in with a specialization:
+//
+//     template <>
+//     struct IsTriviallyRelocatable<MyHandle> : std::true_type {};
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
 template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+namespace detail {
+
+// Raw storage for the first N elements kept inside the object itself.
+// Elements are constructed there lazily, exactly like in a heap buffer.
+template <typename T, size_t N>
+struct InlineStorage {
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(buffer);
+    }
+
+    const T* Data() const noexcept {
+        return reinterpret_cast<const T*>(buffer);
+    }
+
+    alignas(T) std::byte buffer[N * sizeof(T)];
+};
+
+// Without inline capacity the "inline" buffer is nullptr: an empty vector
+// with no allocation is exactly the inline state of size 0.
+template <typename T>
+struct InlineStorage<T, 0> {
+    T* Data() const noexcept {
+        return nullptr;
+    }
+};
+
+}  // namespace detail
+
+// Tag for constructors that default-initialize elements: trivial types are
+// left uninitialized instead of zero-filled
+struct DefaultInitTag {};
+
+inline constexpr DefaultInitTag DefaultInit{};
+
+// Growth policies decide how big the next buffer is once the current one is full.
+// NextCapacity(capacity, min_cap) must return at least min_cap.
+
+// Fewest reallocations, but up to half of the buffer may stay unused
+struct DoublingGrowth {
+    static size_t NextCapacity(size_t capacity, size_t min_cap) noexcept {
+        return std::max(min_cap, capacity * 2);
+    }
+};
+
+// Wastes at most a third of the buffer, at the cost of more reallocations
+struct OneAndHalfGrowth {
+    static size_t NextCapacity(size_t capacity, size_t min_cap) noexcept {
+        return std::max(min_cap, capacity + capacity / 2);
+    }
+};
+
+// x1.5 growth for multi-GB buffers. With the default allocator and trivially
+// relocatable T, a buffer of at least MapThreshold bytes is taken straight
+// from mmap and grown with mremap: the kernel moves page table entries
+// instead of copying the data.
+template <size_t MapThreshold = (size_t{1} << 21)>
+struct HugeBufferGrowth : OneAndHalfGrowth {
+    static constexpr size_t MapThresholdBytes = MapThreshold;
+};
+
+namespace detail {
+
+template <typename Policy>
+concept MapsHugeBuffers = requires {
+    { Policy::MapThresholdBytes } -> std::convertible_to<size_t>;
+};
+
+}  // namespace detail
+
+// Vector<T, Allocator, GrowthPolicy, N>:
+//   * every allocation, construction and destruction goes through
+//     std::allocator_traits<Allocator>, including allocator propagation
+//     on copy/move assignment and Swap;
+//   * GrowthPolicy picks the capacity of every new buffer;
+//   * the first N elements live inside the object (see SmallVector).
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          size_t InlineCapacity = 0>
 class Vector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
+    using AllocatorType = Allocator;
+
     Vector();
 
-    Vector(size_t count, const T& value);
+    explicit Vector(const Allocator& alloc);
+
+    Vector(size_t count, const T& value, const Allocator& alloc = Allocator());
+
+    Vector(size_t count, DefaultInitTag, const Allocator& alloc = Allocator());
 
     Vector(const Vector& other);
 
+    Vector(const Vector& other, const Allocator& alloc);
+
     Vector& operator=(const Vector& other);
 
-    Vector(Vector&& other) noexcept;
+    // Inline elements are relocated, so this may throw only if relocating T may
+    Vector(Vector&& other) noexcept(NothrowSteal);
 
     Vector& operator=(Vector&& other);
 
-    Vector(std::initializer_list<T> init);
+    Vector(std::initializer_list<T> init, const Allocator& alloc = Allocator());
 
     T& operator[](size_t pos);
 
@@ -28,12 +140,22 @@ public:
 
     T* Data() const noexcept;
 
+    Allocator GetAllocator() const;
+
     bool IsEmpty() const noexcept;
 
     size_t Size() const noexcept;
 
     size_t Capacity() const noexcept;
 
+    bool IsInline() const noexcept;
+
+    // True if the buffer is an mmap'ed region grown in place by HugeBufferGrowth
+    bool IsMapped() const noexcept;
+
+    // All zeros unless VECTOR_STATS is defined
+    VectorStats Stats() const noexcept;
+
     void Reserve(size_t new_cap);
 
     void Clear() noexcept;
@@ -42,6 +164,16 @@ public:
 
     void Erase(size_t begin_pos, size_t end_pos);
 
+    // Removes every element satisfying pred in a single pass, moving each survivor
+    // at most once; returns the number of removed elements
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred);
+
+    // Same for the positions in the ascending range [first, last); duplicates and
+    // positions past the end are ignored
+    template <typename InputIt>
+    size_t EraseIndices(InputIt first, InputIt last);
+
     void PushBack(T value);
 
     template <class... Args>
@@ -51,8 +183,118 @@ public:
 
     void Resize(size_t count, const T& value);
 
+    // Appends [first, last) with a single capacity check for forward iterators
+    template <typename InputIt>
+    void AppendRange(InputIt first, InputIt last);
+
+    // New elements are default-initialized: trivial types keep whatever bytes the buffer had
+    void ResizeDefaultInit(size_t count);
+
+    // Same as ResizeDefaultInit, restricted to trivial T so new elements are never touched
+    void ResizeUninitialized(size_t count);
+
+    void Swap(Vector& other);
+
     ~Vector();
 
 private:
-    /*???*/
+    static constexpr size_t InitialCapacity = 10;
+
+#if defined(__linux__)
+    static constexpr bool CanMapPages = detail::MapsHugeBuffers<GrowthPolicy> && IsTriviallyRelocatableV<T> &&
+                                        std::is_same_v<Allocator, std::allocator<T>>;
+#else
+    static constexpr bool CanMapPages = false;
+#endif
+
+    // Whether a heap buffer of this capacity comes from mmap rather than from the allocator
+    static bool IsMappedCapacity(size_t capacity) noexcept;
+
+    T* InlineData() noexcept;
+
+    size_t NextCapacity(size_t min_cap) const noexcept;
+
+    T* Allocate(size_t count);
+
+    void Deallocate(T* data, size_t count) noexcept;
+
+    template <class... Args>
+    void Construct(T* ptr, Args&&... args);
+
+    void Destroy(T* first, T* last) noexcept;
+
+    // Elements may be constructed by pool threads only when the allocator does nothing
+    // but placement new: a stateful allocator is not safe to share between threads
+    static constexpr bool CanConstructInParallel = std::is_same_v<Allocator, std::allocator<T>>;
+
+    // Calls construct_chunk(begin, end) to build [to + begin, to + end) for consecutive chunks
+    // covering count elements, on ParallelPool() once count reaches ParallelThreshold().
+    // construct_chunk must be all or nothing; if any chunk throws, the finished ones are destroyed.
+    template <typename ConstructChunk>
+    void ConstructInChunks(T* to, size_t count, ConstructChunk construct_chunk);
+
+    // Constructs count elements at `to` from *first, *(first + 1), ...; all or nothing
+    template <typename InputIt>
+    void ConstructFrom(InputIt first, size_t count, T* to);
+
+    template <typename InputIt>
+    void ConstructChunkFrom(InputIt first, size_t count, T* to);
+
+    void ConstructFill(T* to, size_t count, const T& value);
+
+    void ConstructChunkFill(T* to, size_t count, const T& value);
+
+    // Single-pass compaction behind EraseIf and EraseIndices: is_removed(pos, element)
+    // is called once for every position, in increasing order
+    template <typename IsRemoved>
+    size_t RemoveWhere(IsRemoved is_removed);
+
+    // Moves count elements from `from` to uninitialized `to` and destroys the originals
+    void Relocate(T* from, size_t count, T* to);
+
+    // Replaces the current buffer with a freshly allocated one of new_cap elements
+    void Reallocate(size_t new_cap);
+
+    // Frees heap storage (if any) and returns to the empty inline state
+    void Reset() noexcept;
+
+    // Relocating inline elements falls back to copying for a T without a
+    // nothrow move, and that copy may throw
+    static constexpr bool NothrowSteal =
+        InlineCapacity == 0 || IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>;
+
+    // Takes over other's elements; `this` must be empty and inline and
+    // other's heap buffer must be deallocatable by our allocator.
+    // If relocation throws, other keeps its elements and `this` stays empty.
+    void StealFrom(Vector& other) noexcept(NothrowSteal);
+
+    // Exchanges elements and buffers, but not the allocators
+    void SwapStorage(Vector& other);
+
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+    [[no_unique_address]] Allocator alloc_;
+    [[no_unique_address]] detail::InlineStorage<T, InlineCapacity> inline_;
+    [[no_unique_address]] detail::StatsRecorder<detail::StatsEnabled> stats_;
 };
+
+// Vector that keeps up to N elements inside the object and touches the heap only past that
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+using SmallVector = Vector<T, Allocator, DoublingGrowth, N>;
+
+// Vector whose buffer starts at a multiple of Alignment bytes
+template <typename T, size_t Alignment = 64, typename GrowthPolicy = DoublingGrowth>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>, GrowthPolicy>;
+
+// AlignedVector that keeps buffers of 2 MB and more on huge pages
+template <typename T, size_t Alignment = 64, typename GrowthPolicy = DoublingGrowth>
+using HugePageVector = Vector<T, HugePageAllocator<T, Alignment>, GrowthPolicy>;
+
+namespace std {
+// Global swap overloading
+template <typename T, typename Allocator, typename GrowthPolicy, size_t N>
+void swap(Vector<T, Allocator, GrowthPolicy, N>& a, Vector<T, Allocator, GrowthPolicy, N>& b) {
+    a.Swap(b);
+}
+}  // namespace std
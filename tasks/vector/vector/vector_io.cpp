@@ -0,0 +1,267 @@
+#include "vector_io.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace detail {
+
+[[noreturn]] inline void ThrowSerializationError(const std::string& what) {
+    throw SerializationException(what + ": " + std::strerror(errno));
+}
+
+inline uint64_t Checksum(const void* data, size_t bytes) noexcept {
+    constexpr uint64_t Prime1 = 0x9e3779b185ebca87;
+    constexpr uint64_t Prime2 = 0xc2b2ae3d27d4eb4f;
+    const auto* ptr = static_cast<const unsigned char*>(data);
+    uint64_t lanes[4] = {Prime1 + Prime2, Prime2, 0, 0 - Prime1};
+    size_t pos = 0;
+    for (; pos + sizeof(lanes) <= bytes; pos += sizeof(lanes)) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, ptr + pos + lane * sizeof(word), sizeof(word));
+            lanes[lane] = std::rotl(lanes[lane] + word * Prime2, 31) * Prime1;
+        }
+    }
+    uint64_t hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) +
+                    std::rotl(lanes[3], 18) + bytes;
+    for (; pos < bytes; ++pos) {
+        hash = (hash ^ ptr[pos]) * Prime1;
+    }
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+inline void CheckSnapshotHeader(const SnapshotHeader& header, size_t element_size, size_t available_bytes) {
+    if (header.magic != SnapshotMagic) {
+        throw SerializationException("not a vector snapshot");
+    }
+    if (header.version != SnapshotVersion || header.header_size != sizeof(SnapshotHeader)) {
+        throw SerializationException("unsupported snapshot version " + std::to_string(header.version));
+    }
+    if (header.element_size != element_size) {
+        throw SerializationException("snapshot of " + std::to_string(header.element_size) + "-byte elements, expected " +
+                                     std::to_string(element_size));
+    }
+    if (header.size > available_bytes / element_size) {
+        throw SerializationException("truncated snapshot");
+    }
+}
+
+inline void CheckChecksum(const SnapshotHeader& header, const void* data) {
+    if (Checksum(data, header.size * header.element_size) != header.checksum) {
+        throw SerializationException("snapshot checksum mismatch");
+    }
+}
+
+// Writes all the buffers, resuming after partial writes
+inline void WriteAll(int fd, iovec* buffers, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, buffers, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowSerializationError("writev failed");
+        }
+        size_t left = written;
+        while (count > 0 && left >= buffers->iov_len) {
+            left -= buffers->iov_len;
+            ++buffers;
+            --count;
+        }
+        if (count > 0) {
+            buffers->iov_base = static_cast<char*>(buffers->iov_base) + left;
+            buffers->iov_len -= left;
+        }
+    }
+}
+
+// Bytes between the current offset and the end of a regular file; SIZE_MAX when
+// fd is not a regular file, since a pipe or socket does not know its length
+inline size_t RemainingBytes(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return SIZE_MAX;
+    }
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0) {
+        return SIZE_MAX;
+    }
+    return st.st_size > offset ? st.st_size - offset : 0;
+}
+
+// Reads up to bytes, resuming after partial reads; returns less only at end of file
+inline size_t ReadAll(int fd, void* to, size_t bytes) {
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t count = read(fd, static_cast<char*>(to) + done, bytes - done);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowSerializationError("read failed");
+        }
+        if (count == 0) {
+            break;
+        }
+        done += count;
+    }
+    return done;
+}
+
+}  // namespace detail
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Serialize(const Vector<T, Allocator, GrowthPolicy, InlineCapacity>& vec, int fd) {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshots store elements as raw bytes");
+    size_t bytes = vec.Size() * sizeof(T);
+    // Zero the padding too: it goes to the file
+    detail::SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = detail::SnapshotMagic;
+    header.version = detail::SnapshotVersion;
+    header.header_size = sizeof(header);
+    header.element_size = sizeof(T);
+    header.size = vec.Size();
+    header.checksum = detail::Checksum(vec.Data(), bytes);
+    iovec buffers[2] = {{&header, sizeof(header)}, {vec.Data(), bytes}};
+    detail::WriteAll(fd, buffers, 2);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Load(int fd, Vector<T, Allocator, GrowthPolicy, InlineCapacity>& vec, ChecksumCheck check) {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshots store elements as raw bytes");
+    vec.Clear();
+    detail::SnapshotHeader header;
+    if (detail::ReadAll(fd, &header, sizeof(header)) != sizeof(header)) {
+        throw SerializationException("truncated snapshot header");
+    }
+    size_t available = detail::RemainingBytes(fd);
+    detail::CheckSnapshotHeader(header, sizeof(T), available);
+    // With a known length the size is already bounded by the file: read it in one go.
+    // Otherwise the buffer grows only as fast as elements actually arrive.
+    constexpr size_t ChunkElements = std::max<size_t>(1, (size_t(1) << 20) / sizeof(T));
+    size_t chunk = available != SIZE_MAX ? header.size : ChunkElements;
+    try {
+        while (vec.Size() < header.size) {
+            size_t done = vec.Size();
+            size_t count = std::min(chunk, header.size - done);
+            if (vec.Capacity() < done + count) {
+                vec.Reserve(std::min<size_t>(header.size, std::max(done + count, 2 * done)));
+            }
+            // Elements are about to be overwritten by read: nothing to initialize
+            vec.ResizeDefaultInit(done + count);
+            size_t bytes = count * sizeof(T);
+            if (detail::ReadAll(fd, vec.Data() + done, bytes) != bytes) {
+                throw SerializationException("truncated snapshot");
+            }
+        }
+        if (check == ChecksumCheck::Verify) {
+            detail::CheckChecksum(header, vec.Data());
+        }
+    } catch (...) {
+        vec.Clear();
+        throw;
+    }
+}
+
+template <typename T>
+VectorView<T>::VectorView(int fd, ChecksumCheck check) : mapping_(nullptr), mapping_bytes_(0), size_(0) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        detail::ThrowSerializationError("cannot stat snapshot");
+    }
+    size_t file_bytes = st.st_size;
+    if (file_bytes < sizeof(detail::SnapshotHeader)) {
+        throw SerializationException("truncated snapshot header");
+    }
+    void* ptr = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+        detail::ThrowSerializationError("mmap failed");
+    }
+    mapping_ = ptr;
+    mapping_bytes_ = file_bytes;
+    try {
+        const auto& header = *static_cast<const detail::SnapshotHeader*>(mapping_);
+        detail::CheckSnapshotHeader(header, sizeof(T), file_bytes - sizeof(header));
+        if (check == ChecksumCheck::Verify) {
+            detail::CheckChecksum(header, Data());
+        }
+        size_ = header.size;
+    } catch (...) {
+        Unmap();
+        throw;
+    }
+}
+
+template <typename T>
+VectorView<T>::VectorView(VectorView&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      mapping_bytes_(std::exchange(other.mapping_bytes_, 0)),
+      size_(std::exchange(other.size_, 0)) {
+}
+
+template <typename T>
+auto VectorView<T>::operator=(VectorView&& other) noexcept -> VectorView& {
+    if (this != &other) {
+        Unmap();
+        Swap(other);
+    }
+    return *this;
+}
+
+template <typename T>
+const T& VectorView<T>::operator[](size_t pos) const noexcept {
+    return Data()[pos];
+}
+
+template <typename T>
+const T* VectorView<T>::Data() const noexcept {
+    if (!mapping_) {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(static_cast<const char*>(mapping_) + sizeof(detail::SnapshotHeader));
+}
+
+template <typename T>
+bool VectorView<T>::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+template <typename T>
+size_t VectorView<T>::Size() const noexcept {
+    return size_;
+}
+
+template <typename T>
+void VectorView<T>::Swap(VectorView& other) noexcept {
+    std::swap(mapping_, other.mapping_);
+    std::swap(mapping_bytes_, other.mapping_bytes_);
+    std::swap(size_, other.size_);
+}
+
+template <typename T>
+VectorView<T>::~VectorView() {
+    Unmap();
+}
+
+template <typename T>
+void VectorView<T>::Unmap() noexcept {
+    if (mapping_) {
+        munmap(mapping_, mapping_bytes_);
+    }
+    mapping_ = nullptr;
+    mapping_bytes_ = 0;
+    size_ = 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+// Binary snapshots of a Vector of trivially copyable elements.
+//
+// A snapshot is a 64-byte header (magic, format version, element size, size
+// and a checksum of the elements) followed by the elements as raw bytes in
+// native byte order:
+//   * Serialize writes header and elements at the current offset of fd with a
+//     single writev, without staging them in a separate buffer;
+//   * Load reads a snapshot at the current offset into a Vector. From a regular
+//     file it checks the size against the bytes left in the file, reserves the
+//     whole buffer and reads the elements with a single read; from a pipe or
+//     socket it grows the buffer in 1 MB chunks as the elements arrive, so a
+//     corrupt size fails at the end of input rather than allocating it;
+//   * VectorView maps a file that starts with a snapshot read-only and reads
+//     the elements straight from the page cache, without copying them.
+//
+// Failing system calls and malformed snapshots throw SerializationException.
+
+enum class ChecksumCheck {
+    Verify,
+    // Trust the elements: a VectorView then touches only the pages it reads
+    Skip,
+};
+
+namespace detail {
+
+struct alignas(64) SnapshotHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t element_size;
+    uint64_t size;
+    uint64_t checksum;
+};
+
+inline constexpr uint64_t SnapshotMagic = 0x0050414e53434556;  // "VECSNAP"
+
+inline constexpr uint32_t SnapshotVersion = 1;
+
+}  // namespace detail
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Serialize(const Vector<T, Allocator, GrowthPolicy, InlineCapacity>& vec, int fd);
+
+// Replaces the contents of vec with the snapshot; vec is left empty if Load throws
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void Load(int fd, Vector<T, Allocator, GrowthPolicy, InlineCapacity>& vec,
+          ChecksumCheck check = ChecksumCheck::Verify);
+
+// Read-only view of a snapshot written at offset 0 of a file. The view owns
+// the mapping and stays valid after fd is closed.
+template <typename T>
+class VectorView {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshots store elements as raw bytes");
+    static_assert(alignof(T) <= alignof(detail::SnapshotHeader), "elements are placed right after the header");
+
+public:
+    explicit VectorView(int fd, ChecksumCheck check = ChecksumCheck::Verify);
+
+    VectorView(const VectorView& other) = delete;
+
+    VectorView& operator=(const VectorView& other) = delete;
+
+    VectorView(VectorView&& other) noexcept;
+
+    VectorView& operator=(VectorView&& other) noexcept;
+
+    const T& operator[](size_t pos) const noexcept;
+
+    const T* Data() const noexcept;
+
+    bool IsEmpty() const noexcept;
+
+    size_t Size() const noexcept;
+
+    void Swap(VectorView& other) noexcept;
+
+    ~VectorView();
+
+private:
+    void Unmap() noexcept;
+
+    void* mapping_;
+    size_t mapping_bytes_;
+    size_t size_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename T>
+void swap(VectorView<T>& a, VectorView<T>& b) {
+    a.Swap(b);
+}
+}  // namespace std
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+// Reallocation statistics of one Vector (Vector::Stats) or of all of them (GlobalVectorStats).
+// They are collected only when VECTOR_STATS is defined, and it must be defined for the
+// whole target since it changes the layout of Vector; otherwise every hook compiles to
+// nothing and the stats stay zero.
+struct VectorStats {
+    static constexpr size_t WasteBuckets = 10;
+
+    size_t reallocations = 0;
+    // Bytes of existing elements relocated into new buffers
+    size_t bytes_moved = 0;
+    // In elements; for the global stats, the largest peak of any vector
+    size_t peak_capacity = 0;
+    // Sampled whenever a heap buffer is released: bucket i counts buffers
+    // whose unused capacity was in [i * 10%, (i + 1) * 10%) of the buffer
+    size_t waste_histogram[WasteBuckets] = {};
+};
+
+namespace detail {
+
+#if defined(VECTOR_STATS)
+inline constexpr bool StatsEnabled = true;
+#else
+inline constexpr bool StatsEnabled = false;
+#endif
+
+struct GlobalStatsCounters {
+    std::atomic<size_t> reallocations = 0;
+    std::atomic<size_t> bytes_moved = 0;
+    std::atomic<size_t> peak_capacity = 0;
+    std::atomic<size_t> waste_histogram[VectorStats::WasteBuckets] = {};
+};
+
+inline GlobalStatsCounters global_stats;
+
+inline size_t WasteBucket(size_t size, size_t capacity) noexcept {
+    size_t bucket = (capacity - size) * VectorStats::WasteBuckets / capacity;
+    return std::min(bucket, VectorStats::WasteBuckets - 1);
+}
+
+// Per-instance stats that also feed the global counters
+template <bool Enabled>
+class StatsRecorder {
+public:
+    void OnReallocate(size_t bytes_moved, size_t new_capacity) noexcept {
+        ++stats_.reallocations;
+        stats_.bytes_moved += bytes_moved;
+        stats_.peak_capacity = std::max(stats_.peak_capacity, new_capacity);
+
+        global_stats.reallocations.fetch_add(1, std::memory_order_relaxed);
+        global_stats.bytes_moved.fetch_add(bytes_moved, std::memory_order_relaxed);
+        size_t peak = global_stats.peak_capacity.load(std::memory_order_relaxed);
+        while (peak < new_capacity &&
+               !global_stats.peak_capacity.compare_exchange_weak(peak, new_capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    void OnRelease(size_t size, size_t capacity) noexcept {
+        if (capacity == 0) {
+            return;
+        }
+        size_t bucket = WasteBucket(size, capacity);
+        ++stats_.waste_histogram[bucket];
+        global_stats.waste_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const VectorStats& Get() const noexcept {
+        return stats_;
+    }
+
+private:
+    VectorStats stats_;
+};
+
+template <>
+class StatsRecorder<false> {
+public:
+    void OnReallocate(size_t, size_t) noexcept {
+    }
+
+    void OnRelease(size_t, size_t) noexcept {
+    }
+
+    VectorStats Get() const noexcept {
+        return {};
+    }
+};
+
+}  // namespace detail
+
+// Sum over every Vector since the start of the program or the last reset
+inline VectorStats GlobalVectorStats() noexcept {
+    VectorStats stats;
+    stats.reallocations = detail::global_stats.reallocations.load(std::memory_order_relaxed);
+    stats.bytes_moved = detail::global_stats.bytes_moved.load(std::memory_order_relaxed);
+    stats.peak_capacity = detail::global_stats.peak_capacity.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < VectorStats::WasteBuckets; ++i) {
+        stats.waste_histogram[i] = detail::global_stats.waste_histogram[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+inline void ResetGlobalVectorStats() noexcept {
+    detail::global_stats.reallocations = 0;
+    detail::global_stats.bytes_moved = 0;
+    detail::global_stats.peak_capacity = 0;
+    for (auto& bucket : detail::global_stats.waste_histogram) {
+        bucket = 0;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "vector_stats.hpp"
+
+// Publishes stats as Google Benchmark user counters next to the timings.
+// Event counts are averaged per iteration; only non-empty waste buckets are shown.
+inline void ReportVectorStats(benchmark::State& state, const VectorStats& stats) {
+    state.counters["reallocs"] = benchmark::Counter(stats.reallocations, benchmark::Counter::kAvgIterations);
+    state.counters["bytes_moved"] = benchmark::Counter(
+        stats.bytes_moved, benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024);
+    state.counters["peak_capacity"] = benchmark::Counter(stats.peak_capacity);
+    for (size_t i = 0; i < VectorStats::WasteBuckets; ++i) {
+        if (stats.waste_histogram[i] != 0) {
+            std::string name = "waste<" + std::to_string((i + 1) * 100 / VectorStats::WasteBuckets) + "%";
+            state.counters[name] = benchmark::Counter(stats.waste_histogram[i]);
+        }
+    }
+}